@@ -0,0 +1,604 @@
+// chess_sim.c - compiled version of chess_sim.sh: same argument, metadata, prompts and boards.
+// the moves are read from the PGN movetext (SAN) directly instead of through parse_moves.py,
+// and every position of the game is computed once up front, so moving forward, back, to the
+// start or to the end is a lookup. each answer (board and next prompt) is one write().
+//
+// gcc -O2 -o chess_sim chess_sim.c
+// ./chess_sim <PGN_FILE>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#define PROMPT "Press 'd' to move forward, 'a' to move back, 'w' to go to the start, 's' to go to the end, 'q' to quit: "
+#define MAX_SAN_LENGTH 16
+
+// board[row * 8 + col], row 0 is rank 8 and col 0 is file a, like the board of chess_sim.sh.
+// white pieces are upper case, black lower case, '.' is an empty square.
+typedef struct
+{
+    char board[64];
+    int white_to_move;
+    int en_passant; // square a pawn can capture onto en passant, -1 if none
+} Position;
+
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t capacity;
+} Buffer;
+
+void buffer_append(Buffer *buffer, const char *text, size_t len)
+{
+    if (buffer->len + len > buffer->capacity)
+    {
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 4096;
+        while (capacity < buffer->len + len)
+        {
+            capacity *= 2;
+        }
+        char *grown = realloc(buffer->data, capacity);
+        if (grown == NULL)
+        {
+            perror("realloc");
+            exit(1);
+        }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->len, text, len);
+    buffer->len += len;
+}
+
+void buffer_puts(Buffer *buffer, const char *text)
+{
+    buffer_append(buffer, text, strlen(text));
+}
+
+void buffer_flush(Buffer *buffer)
+{
+    size_t written = 0;
+    while (written < buffer->len)
+    {
+        ssize_t len = write(STDOUT_FILENO, buffer->data + written, buffer->len - written);
+        if (len == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("write");
+            exit(1);
+        }
+        written += len;
+    }
+    buffer->len = 0;
+}
+
+// board
+
+void init_board(Position *position)
+{
+    const char *start = "rnbqkbnr"
+                        "pppppppp"
+                        "........"
+                        "........"
+                        "........"
+                        "........"
+                        "PPPPPPPP"
+                        "RNBQKBNR";
+    memcpy(position->board, start, 64);
+    position->white_to_move = 1;
+    position->en_passant = -1;
+}
+
+void print_board(Buffer *out, const Position *position, int current_move, int total_moves)
+{
+    char line[64];
+    snprintf(line, sizeof(line), "Move %d/%d\n", current_move, total_moves);
+    buffer_puts(out, line);
+    buffer_puts(out, "  a b c d e f g h\n");
+    for (int row = 0; row < 8; row++)
+    {
+        int len = 0;
+        line[len++] = '0' + 8 - row;
+        line[len++] = ' ';
+        for (int col = 0; col < 8; col++)
+        {
+            line[len++] = position->board[row * 8 + col];
+            line[len++] = ' ';
+        }
+        line[len++] = '0' + 8 - row;
+        line[len++] = '\n';
+        buffer_append(out, line, len);
+    }
+    buffer_puts(out, "  a b c d e f g h\n");
+}
+
+int is_white_piece(char piece)
+{
+    return isupper((unsigned char)piece);
+}
+
+int is_black_piece(char piece)
+{
+    return islower((unsigned char)piece);
+}
+
+int own_piece(char piece, int white)
+{
+    return white ? is_white_piece(piece) : is_black_piece(piece);
+}
+
+// can the piece on from attack to (ignoring whose turn it is and what stands on to)
+int attacks(const char *board, int from, int to)
+{
+    int from_row = from / 8, from_col = from % 8;
+    int to_row = to / 8, to_col = to % 8;
+    int d_row = to_row - from_row, d_col = to_col - from_col;
+    int abs_row = abs(d_row), abs_col = abs(d_col);
+    char piece = board[from];
+
+    switch (toupper((unsigned char)piece))
+    {
+    case 'P':
+        // white pawns go up the board (towards row 0)
+        return abs_col == 1 && d_row == (is_white_piece(piece) ? -1 : 1);
+    case 'N':
+        return (abs_row == 1 && abs_col == 2) || (abs_row == 2 && abs_col == 1);
+    case 'K':
+        return (abs_row | abs_col) != 0 && abs_row <= 1 && abs_col <= 1;
+    case 'B':
+        if (abs_row != abs_col || abs_row == 0)
+            return 0;
+        break;
+    case 'R':
+        if ((d_row != 0 && d_col != 0) || (abs_row | abs_col) == 0)
+            return 0;
+        break;
+    case 'Q':
+        if (!(abs_row == abs_col || d_row == 0 || d_col == 0) || (abs_row | abs_col) == 0)
+            return 0;
+        break;
+    default:
+        return 0;
+    }
+    // sliding piece: the squares in between must be empty
+    int step_row = (d_row > 0) - (d_row < 0), step_col = (d_col > 0) - (d_col < 0);
+    int row = from_row + step_row, col = from_col + step_col;
+    while (row != to_row || col != to_col)
+    {
+        if (board[row * 8 + col] != '.')
+            return 0;
+        row += step_row;
+        col += step_col;
+    }
+    return 1;
+}
+
+int square_attacked(const char *board, int square, int by_white)
+{
+    for (int from = 0; from < 64; from++)
+    {
+        if (own_piece(board[from], by_white) && attacks(board, from, square))
+            return 1;
+    }
+    return 0;
+}
+
+int king_in_check(const char *board, int white)
+{
+    char king = white ? 'K' : 'k';
+    for (int square = 0; square < 64; square++)
+    {
+        if (board[square] == king)
+            return square_attacked(board, square, !white);
+    }
+    return 0;
+}
+
+// play a move that is known to be legal: castling moves the rook too, a pawn moving
+// diagonally onto an empty square captures en passant, promotion is 'q', 'r', 'b', 'n' or 0
+void make_move(Position *position, int from, int to, char promotion)
+{
+    char *board = position->board;
+    char piece = board[from];
+    int white = is_white_piece(piece);
+    int is_pawn = toupper((unsigned char)piece) == 'P';
+
+    if (is_pawn && from % 8 != to % 8 && board[to] == '.')
+    {
+        board[from / 8 * 8 + to % 8] = '.';
+    }
+    if (toupper((unsigned char)piece) == 'K' && abs(to % 8 - from % 8) == 2)
+    {
+        int row = from / 8;
+        int rook_from = to % 8 == 6 ? row * 8 + 7 : row * 8;
+        int rook_to = to % 8 == 6 ? row * 8 + 5 : row * 8 + 3;
+        board[rook_to] = board[rook_from];
+        board[rook_from] = '.';
+    }
+    board[to] = piece;
+    board[from] = '.';
+    if (is_pawn && promotion)
+    {
+        board[to] = white ? toupper((unsigned char)promotion) : tolower((unsigned char)promotion);
+    }
+
+    position->en_passant = is_pawn && abs(to / 8 - from / 8) == 2 ? (from + to) / 2 : -1;
+    position->white_to_move = !position->white_to_move;
+}
+
+int legal_after(const Position *position, int from, int to, char promotion)
+{
+    Position next = *position;
+    make_move(&next, from, to, promotion);
+    return !king_in_check(next.board, position->white_to_move);
+}
+
+int parse_square(const char *text)
+{
+    if (text[0] < 'a' || text[0] > 'h' || text[1] < '1' || text[1] > '8')
+        return -1;
+    return (8 - (text[1] - '0')) * 8 + (text[0] - 'a');
+}
+
+// resolve a SAN move ("Nbd7", "exd6", "e8=Q+", "O-O") in position, -1 if it isn't legal there
+int resolve_san(const Position *position, const char *san, int *from_out, int *to_out, char *promotion_out)
+{
+    char move[MAX_SAN_LENGTH];
+    size_t len = 0;
+    for (const char *c = san; *c && len + 1 < sizeof(move); c++)
+    {
+        if (!strchr("+#!?", *c))
+            move[len++] = *c;
+    }
+    move[len] = '\0';
+
+    int white = position->white_to_move;
+    const char *board = position->board;
+    *promotion_out = 0;
+
+    if (strcmp(move, "O-O") == 0 || strcmp(move, "0-0") == 0 || strcmp(move, "O-O-O") == 0 ||
+        strcmp(move, "0-0-0") == 0)
+    {
+        int row = white ? 7 : 0;
+        int from = row * 8 + 4;
+        int to = row * 8 + (len == 3 ? 6 : 2);
+        if (board[from] != (white ? 'K' : 'k') || !legal_after(position, from, to, 0))
+            return -1;
+        *from_out = from;
+        *to_out = to;
+        return 0;
+    }
+
+    // promotion: "e8=Q" or "e8Q"
+    if (len >= 3 && strchr("QRBNqrbn", move[len - 1]) && (move[len - 2] == '=' || isdigit((unsigned char)move[len - 2])))
+    {
+        *promotion_out = tolower((unsigned char)move[len - 1]);
+        len -= move[len - 2] == '=' ? 2 : 1;
+        move[len] = '\0';
+    }
+    if (len < 2)
+        return -1;
+    int to = parse_square(move + len - 2);
+    if (to == -1 || own_piece(board[to], white))
+        return -1;
+
+    char type = 'P';
+    size_t start = 0;
+    if (strchr("KQRBN", move[0]))
+    {
+        type = move[0];
+        start = 1;
+    }
+    // what's left between the piece and the target: disambiguation and 'x'
+    int from_col = -1, from_row = -1, capture = 0;
+    for (size_t i = start; i < len - 2; i++)
+    {
+        if (move[i] >= 'a' && move[i] <= 'h')
+            from_col = move[i] - 'a';
+        else if (move[i] >= '1' && move[i] <= '8')
+            from_row = 8 - (move[i] - '0');
+        else if (move[i] == 'x' || move[i] == ':')
+            capture = 1;
+        else
+            return -1;
+    }
+
+    char piece = white ? type : tolower((unsigned char)type);
+    int found = -1;
+    for (int from = 0; from < 64; from++)
+    {
+        if (board[from] != piece)
+            continue;
+        if ((from_col != -1 && from % 8 != from_col) || (from_row != -1 && from / 8 != from_row))
+            continue;
+        int reachable;
+        if (type == 'P')
+        {
+            int forward = white ? -8 : 8;
+            if (capture || from % 8 != to % 8)
+            {
+                reachable = attacks(board, from, to) && (board[to] != '.' || to == position->en_passant);
+            }
+            else
+            {
+                int start_row = white ? 6 : 1;
+                reachable = board[to] == '.' &&
+                            (to == from + forward ||
+                             (from / 8 == start_row && to == from + 2 * forward && board[from + forward] == '.'));
+            }
+        }
+        else
+        {
+            reachable = attacks(board, from, to);
+        }
+        if (!reachable || !legal_after(position, from, to, *promotion_out))
+            continue;
+        if (found != -1)
+            return -1; // ambiguous
+        found = from;
+    }
+    if (found == -1)
+        return -1;
+    *from_out = found;
+    *to_out = to;
+    return 0;
+}
+
+// PGN
+
+int is_result(const char *token, size_t len)
+{
+    return (len == 1 && token[0] == '*') || (len == 3 && strncmp(token, "1-0", 3) == 0) ||
+           (len == 3 && strncmp(token, "0-1", 3) == 0) || (len == 7 && strncmp(token, "1/2-1/2", 7) == 0);
+}
+
+// the next move of the movetext, 0 at its end: skips comments ({...} and ; to the end of the
+// line), variations ((...)), NAGs ($n) and move numbers ("12." "12..."), and stops at the result
+int next_san(const char **cursor, char *san)
+{
+    const char *c = *cursor;
+    int depth = 0;
+    while (*c)
+    {
+        if (isspace((unsigned char)*c))
+        {
+            c++;
+            continue;
+        }
+        if (*c == '{' || *c == ';')
+        {
+            const char *end = strchr(c, *c == '{' ? '}' : '\n');
+            c = end ? end + 1 : c + strlen(c);
+            continue;
+        }
+        if (*c == '(' || *c == ')')
+        {
+            depth += *c == '(' ? 1 : (depth > 0 ? -1 : 0);
+            c++;
+            continue;
+        }
+
+        const char *token = c;
+        while (*c && !isspace((unsigned char)*c) && !strchr("{}();", *c))
+            c++;
+        size_t len = c - token;
+        if (depth > 0 || *token == '$')
+            continue;
+        if (is_result(token, len))
+            break;
+        // "12." "12..." "12.e4" (but not "0-0", castling)
+        if (strncmp(token, "0-0", 3) != 0)
+        {
+            while (len > 0 && (isdigit((unsigned char)*token) || *token == '.'))
+            {
+                token++;
+                len--;
+            }
+        }
+        if (len == 0)
+            continue;
+        if (len >= MAX_SAN_LENGTH)
+            len = MAX_SAN_LENGTH - 1;
+        memcpy(san, token, len);
+        san[len] = '\0';
+        *cursor = c;
+        return 1;
+    }
+    *cursor = c;
+    return 0;
+}
+
+// print the tag lines (like chess_sim.sh: every line starting with '[' after trimming) and
+// return the rest of the file as the movetext
+char *read_pgn_file(FILE *file, Buffer *out)
+{
+    Buffer movetext = {0};
+    char *line = NULL;
+    size_t line_cap = 0;
+    ssize_t line_len;
+    buffer_puts(out, "Metadata from PGN file:\n");
+    while ((line_len = getline(&line, &line_cap, file)) != -1)
+    {
+        char *start = line;
+        char *end = line + line_len;
+        while (start < end && (*start == ' ' || *start == '\t'))
+            start++;
+        while (end > start && (end[-1] == '\n' || end[-1] == ' ' || end[-1] == '\t'))
+            end--;
+        if (start < end && *start == '[')
+        {
+            buffer_append(out, start, end - start);
+            buffer_puts(out, "\n");
+        }
+        else
+        {
+            buffer_append(&movetext, start, end - start);
+            buffer_puts(&movetext, "\n");
+        }
+    }
+    free(line);
+    buffer_append(&movetext, "", 1);
+    return movetext.data;
+}
+
+// every position of the game: positions[0] is the start, positions[i] after i moves
+Position *replay_game(const char *movetext, int *total_moves)
+{
+    size_t capacity = 256;
+    Position *positions = malloc(capacity * sizeof(Position));
+    if (positions == NULL)
+    {
+        perror("malloc");
+        exit(1);
+    }
+    init_board(&positions[0]);
+
+    int count = 0;
+    char san[MAX_SAN_LENGTH];
+    const char *cursor = movetext;
+    while (next_san(&cursor, san))
+    {
+        int from, to;
+        char promotion;
+        if (resolve_san(&positions[count], san, &from, &to, &promotion) == -1)
+        {
+            fprintf(stderr, "Illegal move %s after %d moves, ignoring the rest of the game\n", san, count);
+            break;
+        }
+        if ((size_t)count + 2 > capacity)
+        {
+            capacity *= 2;
+            Position *grown = realloc(positions, capacity * sizeof(Position));
+            if (grown == NULL)
+            {
+                perror("realloc");
+                exit(1);
+            }
+            positions = grown;
+        }
+        positions[count + 1] = positions[count];
+        make_move(&positions[count + 1], from, to, promotion);
+        count++;
+    }
+    *total_moves = count;
+    return positions;
+}
+
+// read one key like bash's read: surrounding blanks dropped, backslashes removed.
+// returns 0 at end of input
+int read_key(char **line, size_t *line_cap, char *key, size_t size)
+{
+    ssize_t line_len = getline(line, line_cap, stdin);
+    if (line_len == -1)
+        return 0;
+    size_t len = 0;
+    for (ssize_t i = 0; i < line_len; i++)
+    {
+        char c = (*line)[i];
+        if (c == '\\' && i + 1 < line_len)
+            c = (*line)[++i];
+        else if (c == '\n')
+            break;
+        if (len + 1 < size)
+            key[len++] = c;
+    }
+    key[len] = '\0';
+    char *start = key;
+    while (*start == ' ' || *start == '\t')
+        start++;
+    while (len > 0 && (key[len - 1] == ' ' || key[len - 1] == '\t'))
+        key[--len] = '\0';
+    memmove(key, start, strlen(start) + 1);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 2)
+    {
+        printf("Usage: %s <PGN_FILE>\n", argv[0]);
+        return 1;
+    }
+    struct stat path_stat;
+    if (stat(argv[1], &path_stat) != 0 || !S_ISREG(path_stat.st_mode))
+    {
+        printf("File does not exist: %s\n", argv[1]);
+        return 1;
+    }
+    FILE *file = fopen(argv[1], "r");
+    if (file == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    Buffer out = {0};
+    char *movetext = read_pgn_file(file, &out);
+    fclose(file);
+    int total_moves;
+    Position *positions = replay_game(movetext, &total_moves);
+    free(movetext);
+
+    int current_move = 0;
+    print_board(&out, &positions[current_move], current_move, total_moves);
+    char *line = NULL;
+    size_t line_cap = 0;
+    char key[256];
+    while (1)
+    {
+        buffer_puts(&out, PROMPT);
+        buffer_flush(&out);
+        if (!read_key(&line, &line_cap, key, sizeof(key)))
+            break;
+
+        if (strcmp(key, "d") == 0)
+        {
+            if (current_move >= total_moves)
+            {
+                buffer_puts(&out, "No more moves available.\n");
+                continue;
+            }
+            current_move++;
+        }
+        else if (strcmp(key, "a") == 0)
+        {
+            if (current_move > 0)
+                current_move--;
+        }
+        else if (strcmp(key, "w") == 0)
+        {
+            current_move = 0;
+        }
+        else if (strcmp(key, "s") == 0)
+        {
+            current_move = total_moves;
+        }
+        else if (strcmp(key, "q") == 0)
+        {
+            buffer_puts(&out, "Exiting.\nEnd of game.\n");
+            buffer_flush(&out);
+            break;
+        }
+        else
+        {
+            buffer_puts(&out, "Invalid key pressed: ");
+            buffer_puts(&out, key);
+            buffer_puts(&out, "\n");
+            continue;
+        }
+        print_board(&out, &positions[current_move], current_move, total_moves);
+    }
+
+    free(line);
+    free(positions);
+    free(out.data);
+    return 0;
+}
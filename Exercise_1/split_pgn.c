@@ -0,0 +1,201 @@
+// split_pgn.c - the same splitter as split_pgn.sh, for big PGN databases.
+// same arguments, messages, file names and file contents:
+// a game starts at a line beginning with "[Event " and runs until the next one. it's written
+// without its last newline, and without one empty line at its end (the blank line before the
+// next game). anything before the first game is skipped.
+//
+// gcc -O2 -o split_pgn split_pgn.c
+// ./split_pgn <source_pgn_file> <destination_directory>
+
+#define _GNU_SOURCE // memmem
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#define EVENT_TAG "[Event "
+
+int is_regular_file(const char *path)
+{
+    struct stat path_stat;
+    if (stat(path, &path_stat) != 0)
+    {
+        return 0;
+    }
+    return S_ISREG(path_stat.st_mode);
+}
+
+int directory_exists(const char *path)
+{
+    struct stat path_stat;
+    if (stat(path, &path_stat) != 0)
+    {
+        return 0;
+    }
+    return S_ISDIR(path_stat.st_mode);
+}
+
+// "dir/capmemel24.pgn" -> "capmemel24"
+void game_file_prefix(const char *input_file, char *prefix, size_t size)
+{
+    const char *name = strrchr(input_file, '/');
+    name = name ? name + 1 : input_file;
+    size_t len = strlen(name);
+    if (len >= 4 && strcmp(name + len - 4, ".pgn") == 0)
+    {
+        len -= 4;
+    }
+    snprintf(prefix, size, "%.*s", (int)len, name);
+}
+
+// start of the next line beginning with "[Event " at or after from, end if there is none
+const char *next_game(const char *data, const char *from, const char *end)
+{
+    size_t tag_len = strlen(EVENT_TAG);
+    if (from == data && (size_t)(end - from) >= tag_len && memcmp(from, EVENT_TAG, tag_len) == 0)
+    {
+        return from;
+    }
+    // the tag at the start of a line: look for "\n[Event " from the newline before from
+    const char *search = from > data ? from - 1 : from;
+    const char *found = memmem(search, end - search, "\n" EVENT_TAG, tag_len + 1);
+    return found ? found + 1 : end;
+}
+
+int write_game(const char *path, const char *game, size_t len)
+{
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (fd == -1)
+    {
+        perror(path);
+        return -1;
+    }
+    while (len > 0)
+    {
+        ssize_t written = write(fd, game, len);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror(path);
+            close(fd);
+            return -1;
+        }
+        game += written;
+        len -= written;
+    }
+    close(fd);
+    return 0;
+}
+
+int split_games(const char *input_file, const char *dest_dir)
+{
+    int fd = open(input_file, O_RDONLY);
+    if (fd == -1)
+    {
+        perror(input_file);
+        return -1;
+    }
+    struct stat input_stat;
+    if (fstat(fd, &input_stat) == -1)
+    {
+        perror(input_file);
+        close(fd);
+        return -1;
+    }
+
+    size_t size = input_stat.st_size;
+    const char *data = NULL;
+    if (size > 0)
+    {
+        data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            perror("mmap");
+            close(fd);
+            return -1;
+        }
+        madvise((void *)data, size, MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    char prefix[1024];
+    game_file_prefix(input_file, prefix, sizeof(prefix));
+    char *output_file = malloc(strlen(dest_dir) + strlen(prefix) + 32);
+    if (output_file == NULL)
+    {
+        perror("malloc");
+        return -1;
+    }
+
+    int result = 0;
+    int game_no = 0;
+    const char *end = data + size;
+    const char *game = size > 0 ? next_game(data, data, end) : end;
+    while (game < end)
+    {
+        const char *game_end = next_game(data, game + 1, end);
+        game_no++;
+        sprintf(output_file, "%s/%s_%d.pgn", dest_dir, prefix, game_no);
+        printf("Saved game to %s\n", output_file);
+
+        // drop the newline of the last line, then the last line itself if it's empty
+        size_t len = game_end - game;
+        if (len > 0 && game[len - 1] == '\n')
+        {
+            len--;
+        }
+        if (len > 0 && game[len - 1] == '\n')
+        {
+            len--;
+        }
+        if (write_game(output_file, game, len) == -1)
+        {
+            result = -1;
+        }
+        game = game_end;
+    }
+
+    printf("All games have been split and saved to '%s'.\n", dest_dir);
+    free(output_file);
+    if (size > 0)
+    {
+        munmap((void *)data, size);
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3)
+    {
+        printf("Usage: %s <source_pgn_file> <destination_directory>\n", argv[0]);
+        return 1;
+    }
+    const char *input_file = argv[1];
+    const char *dest_dir = argv[2];
+
+    if (!is_regular_file(input_file))
+    {
+        printf("Error: File '%s' does not exist.\n", input_file);
+        return 1;
+    }
+    if (!directory_exists(dest_dir))
+    {
+        if (mkdir(dest_dir, 0777) == -1)
+        {
+            perror(dest_dir);
+            return 1;
+        }
+        printf("Created directory '%s'.\n", dest_dir);
+    }
+
+    return split_games(input_file, dest_dir) == -1 ? 1 : 0;
+}
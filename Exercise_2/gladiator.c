@@ -3,100 +3,172 @@
 // attack power
 // opponent queue
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 
-#define NUM_OPPONENTS 3
+#include "gladiator_table.c"
+#include "gladiator_log.c"
 
 typedef struct
 {
     int health;
     int attack_power;
-    int opponents[NUM_OPPONENTS];
+    int num_opponents;
+    int* opponents;
+    int* opponent_attacks; // attack power of opponents[i], resolved once before the fight
 } Gladiator;
 
-// read stats from file
-void get_gladiator_filename(const char* glad_name, char* filename) {
-    sprintf(filename, "%s.txt", glad_name);
+// gladiator number from a base name like "G12", 0 if the name has another form
+int get_gladiator_number(const char* glad_name)
+{
+    if (glad_name[0] != 'G' || !isdigit((unsigned char)glad_name[1]))
+    {
+        return 0;
+    }
+    return atoi(glad_name + 1);
 }
 
-void get_gladiator_log_filename(const char* glad_name, char* filename) {
-    sprintf(filename, "%s_log.txt", glad_name);
+int allocate_opponents(Gladiator* gladiator, int num_opponents)
+{
+    gladiator->num_opponents = num_opponents;
+    gladiator->opponents = malloc((num_opponents + 1) * sizeof(int));
+    gladiator->opponent_attacks = malloc((num_opponents + 1) * sizeof(int));
+    if (gladiator->opponents == NULL || gladiator->opponent_attacks == NULL)
+    {
+        perror("malloc");
+        return -1;
+    }
+    return 0;
 }
 
-// Get gladiator by base name (e.g., "G1")
-Gladiator get_gladiator_by_name(const char* glad_name)
+// take everything from the table the tournament published
+int load_from_table(const GladiatorTable* table, int glad_no, Gladiator* gladiator)
 {
-    Gladiator gladiator;
-    char filename[64];
-    get_gladiator_filename(glad_name, filename);
-
-    FILE *file = fopen(filename, "r");
-    if (file == NULL)
+    int index = glad_no - 1;
+    gladiator->health = table->health[index];
+    gladiator->attack_power = table->attack[index];
+    if (allocate_opponents(gladiator, table_num_opponents(table, index)) == -1)
     {
-        perror("Error opening file");
-        gladiator.health = 0;
-        gladiator.attack_power = 0;
-        return gladiator;
+        return -1;
     }
-    fscanf(file, "%d, %d, %d, %d, %d", &gladiator.health, &gladiator.attack_power,
-           &gladiator.opponents[0], &gladiator.opponents[1], &gladiator.opponents[2]);
-    fclose(file);
-    return gladiator;
+    const int* opponents = table_opponents(table, index);
+    for (int i = 0; i < gladiator->num_opponents; i++)
+    {
+        gladiator->opponents[i] = opponents[i];
+        gladiator->opponent_attacks[i] = table_attack(table, opponents[i]);
+    }
+    return 0;
 }
 
-int get_opponent_attack(int opp_no) {
-    char opp_name[10];
-    sprintf(opp_name, "G%d", opp_no);
-    Gladiator opp = get_gladiator_by_name(opp_name);
-    return opp.attack_power;
+// no table (started by hand): read our own file and each opponent's file once
+int preload_stats(const char* glad_name, Gladiator* gladiator)
+{
+    int* opponents = NULL;
+    int opponents_len = 0, opponents_cap = 0;
+    int num_opponents = parse_gladiator_stats(glad_name, &gladiator->health, &gladiator->attack_power,
+                                              &opponents, &opponents_len, &opponents_cap);
+    if (num_opponents == -1)
+    {
+        gladiator->health = 0;
+        gladiator->attack_power = 0;
+        num_opponents = 0;
+    }
+    if (allocate_opponents(gladiator, num_opponents) == -1)
+    {
+        free(opponents);
+        return -1;
+    }
+
+    int* scratch = NULL;
+    int scratch_len = 0, scratch_cap = 0;
+    for (int i = 0; i < num_opponents; i++)
+    {
+        char opp_name[16];
+        int opp_health, opp_attack = 0;
+        snprintf(opp_name, sizeof(opp_name), "G%d", opponents[i]);
+        scratch_len = 0;
+        if (parse_gladiator_stats(opp_name, &opp_health, &opp_attack, &scratch, &scratch_len, &scratch_cap) == -1)
+        {
+            opp_attack = 0;
+        }
+        gladiator->opponents[i] = opponents[i];
+        gladiator->opponent_attacks[i] = opp_attack;
+    }
+    free(scratch);
+    free(opponents);
+    return 0;
 }
 
 int main(int argc, char const *argv[])
 {
-    if (argc != 2)
+    if (argc != 2 && argc != 3)
     {
-        fprintf(stderr, "Usage: %s <gladiator_name> (e.g., G1)\n", argv[0]);
+        fprintf(stderr, "Usage: %s <gladiator_name> [<gladiator_number>] (e.g., G1)\n", argv[0]);
         return 1;
     }
-    
+
     const char* gladiator_name = argv[1];
-    
-    Gladiator my_glad = get_gladiator_by_name(gladiator_name);
-    
-    // open log file
-    char log_filename[64];
-    get_gladiator_log_filename(gladiator_name, log_filename);
-    FILE *logFile = fopen(log_filename, "w");
-    if (logFile == NULL)
+    int glad_no = argc == 3 ? atoi(argv[2]) : get_gladiator_number(gladiator_name);
+
+    Gladiator my_glad;
+    GladiatorTable table = {0};
+    table.fd = -1;
+    if (table_attach(&table) == 0 && glad_no >= 1 && glad_no <= table.count)
+    {
+        if (load_from_table(&table, glad_no, &my_glad) == -1)
+        {
+            return 1;
+        }
+    }
+    else if (preload_stats(gladiator_name, &my_glad) == -1)
     {
-        perror("Error opening log file");
         return 1;
     }
-    
+    table_destroy(&table);
+
     int health = my_glad.health;
+    if (health > 0 && my_glad.num_opponents == 0)
+    {
+        fprintf(stderr, "%s has no opponents and can never fall\n", gladiator_name);
+        return 1;
+    }
+
+    // open log file
+    int binary = log_binary_requested();
+    char log_filename[GLADIATOR_FILENAME_LEN];
+    get_log_filename(gladiator_name, binary, log_filename, sizeof(log_filename));
+    GladiatorLog fight_log;
+    if (log_open(&fight_log, log_filename, binary) == -1)
+    {
+        return 1;
+    }
+
     // print here the pid as I mentioned
     int pid = getpid();
     // write pid to log file
-    fprintf(logFile, "Gladiator process started. %d:\n", pid);
-    
+    log_started(&fight_log, pid);
+
+    // no file I/O in the fight apart from the (batched) log
     while (health > 0) {
-        for (int i = 0; i < 3; i++) {
-            int opponent_attack = get_opponent_attack(my_glad.opponents[i]);
-            fprintf(logFile, "Facing opponent %d... Taking %d damage\n", my_glad.opponents[i], opponent_attack);
+        for (int i = 0; i < my_glad.num_opponents; i++) {
+            int opponent_attack = my_glad.opponent_attacks[i];
             health -= opponent_attack;
-            if (health > 0) {
-                fprintf(logFile, "Are you not entertained? Remaining health: %d\n", health);
-            } else {
-                fprintf(logFile, "The gladiator has fallen... Final health: %d\n", health);
+            log_hit(&fight_log, my_glad.opponents[i], opponent_attack, health);
+            if (health <= 0) {
                 break;
             }
         }
     }
-    
-    fclose(logFile);
+
+    if (log_close(&fight_log) == -1)
+    {
+        return 1;
+    }
+    free(my_glad.opponents);
+    free(my_glad.opponent_attacks);
     return 0;
-}
\ No newline at end of file
+}
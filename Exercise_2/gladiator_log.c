@@ -0,0 +1,249 @@
+// fight log shared by gladiator.c, tournament.c (simulation mode) and log_printer.c
+//
+// lines are formatted by hand into a ring of fixed-size chunks and the whole ring
+// is written with a single writev() once it is full, instead of two fprintf calls
+// per hit. each process owns its log, so there is no locking.
+//
+// text format (default): the lines from Part1.md, written to "<name>_log.txt".
+// binary format (GLADIATOR_LOG_FORMAT=binary): written to "<name>_log.bin",
+//   header: "GLOG", int32 version, int32 pid
+//   one record per hit: int32 opponent, int32 damage, int32 remaining health
+//   (native byte order). ./log_printer turns it back into the text format.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+
+#define GLADIATOR_LOG_FORMAT_ENV "GLADIATOR_LOG_FORMAT"
+#define LOG_CHUNK_SIZE (64 * 1024)
+#define LOG_RING_CHUNKS 16
+#define LOG_MAX_RECORD 160 // longest hit entry in either format
+#define LOG_MAGIC "GLOG"
+#define LOG_VERSION 1
+
+typedef struct
+{
+    int fd;
+    int binary;
+    char* ring;                     // LOG_RING_CHUNKS chunks of LOG_CHUNK_SIZE bytes
+    size_t used[LOG_RING_CHUNKS];
+    int current;                    // chunk being filled
+    int failed;                     // a write failed, the rest of the log is dropped
+} GladiatorLog;
+
+typedef struct
+{
+    int opponent;
+    int damage;
+    int health;
+} LogRecord;
+
+// binary logs are selected by the environment, so the tournament can switch every gladiator at once
+int log_binary_requested()
+{
+    const char* format = getenv(GLADIATOR_LOG_FORMAT_ENV);
+    return format != NULL && strcmp(format, "binary") == 0;
+}
+
+void get_log_filename(const char* glad_name, int binary, char* filename, size_t size)
+{
+    snprintf(filename, size, binary ? "%s_log.bin" : "%s_log.txt", glad_name);
+}
+
+// write all chunks with as few writev calls as possible. after a failed write nothing
+// more is written, and log_close fails
+int log_flush(GladiatorLog* log)
+{
+    struct iovec iov[LOG_RING_CHUNKS];
+    int iov_count = 0;
+    for (int i = 0; i <= log->current; i++)
+    {
+        if (log->used[i] > 0)
+        {
+            iov[iov_count].iov_base = log->ring + (size_t)i * LOG_CHUNK_SIZE;
+            iov[iov_count].iov_len = log->used[i];
+            iov_count++;
+        }
+        log->used[i] = 0;
+    }
+    log->current = 0;
+    // don't append after a gap: the error is reported once, by log_close
+    if (log->failed)
+    {
+        return -1;
+    }
+
+    struct iovec* pending = iov;
+    while (iov_count > 0)
+    {
+        ssize_t written = writev(log->fd, pending, iov_count);
+        if (written == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("writev");
+            log->failed = 1;
+            return -1;
+        }
+        // skip what was written, a short write can end in the middle of a chunk
+        while (iov_count > 0 && (size_t)written >= pending->iov_len)
+        {
+            written -= pending->iov_len;
+            pending++;
+            iov_count--;
+        }
+        if (iov_count > 0)
+        {
+            pending->iov_base = (char*)pending->iov_base + written;
+            pending->iov_len -= written;
+        }
+    }
+    return 0;
+}
+
+// room for one more entry, moving to the next chunk (or flushing the ring) if needed
+char* log_reserve(GladiatorLog* log)
+{
+    if (log->used[log->current] + LOG_MAX_RECORD > LOG_CHUNK_SIZE)
+    {
+        if (log->current + 1 == LOG_RING_CHUNKS)
+        {
+            log_flush(log);
+        }
+        else
+        {
+            log->current++;
+        }
+    }
+    return log->ring + (size_t)log->current * LOG_CHUNK_SIZE + log->used[log->current];
+}
+
+char* append_str(char* out, const char* str, size_t len)
+{
+    memcpy(out, str, len);
+    return out + len;
+}
+
+char* append_int(char* out, int value)
+{
+    char digits[12];
+    int len = 0;
+    unsigned int magnitude = value < 0 ? -(unsigned int)value : (unsigned int)value;
+    do
+    {
+        digits[len++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0);
+    if (value < 0)
+    {
+        *out++ = '-';
+    }
+    while (len > 0)
+    {
+        *out++ = digits[--len];
+    }
+    return out;
+}
+
+#define APPEND_LITERAL(out, literal) append_str(out, literal, sizeof(literal) - 1)
+
+// use an already open fd (e.g. stdout for log_printer)
+int log_open_fd(GladiatorLog* log, int fd, int binary)
+{
+    log->fd = fd;
+    log->binary = binary;
+    log->current = 0;
+    log->failed = 0;
+    memset(log->used, 0, sizeof(log->used));
+    log->ring = malloc((size_t)LOG_RING_CHUNKS * LOG_CHUNK_SIZE);
+    if (log->ring == NULL)
+    {
+        perror("malloc");
+        return -1;
+    }
+    return 0;
+}
+
+int log_open(GladiatorLog* log, const char* filename, int binary)
+{
+    int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+    {
+        perror("Error opening log file");
+        return -1;
+    }
+    if (log_open_fd(log, fd, binary) == -1)
+    {
+        close(fd);
+        return -1;
+    }
+    return 0;
+}
+
+void log_started(GladiatorLog* log, int pid)
+{
+    char* start = log_reserve(log);
+    char* out = start;
+    if (log->binary)
+    {
+        int header[2] = {LOG_VERSION, pid};
+        out = append_str(out, LOG_MAGIC, 4);
+        out = append_str(out, (const char*)header, sizeof(header));
+    }
+    else
+    {
+        out = APPEND_LITERAL(out, "Gladiator process started. ");
+        out = append_int(out, pid);
+        out = APPEND_LITERAL(out, ":\n");
+    }
+    log->used[log->current] += out - start;
+}
+
+// one hit: the opponent's damage and the health left after it
+void log_hit(GladiatorLog* log, int opponent, int damage, int health)
+{
+    char* start = log_reserve(log);
+    char* out = start;
+    if (log->binary)
+    {
+        LogRecord record = {opponent, damage, health};
+        out = append_str(out, (const char*)&record, sizeof(record));
+    }
+    else
+    {
+        out = APPEND_LITERAL(out, "Facing opponent ");
+        out = append_int(out, opponent);
+        out = APPEND_LITERAL(out, "... Taking ");
+        out = append_int(out, damage);
+        if (health > 0)
+        {
+            out = APPEND_LITERAL(out, " damage\nAre you not entertained? Remaining health: ");
+        }
+        else
+        {
+            out = APPEND_LITERAL(out, " damage\nThe gladiator has fallen... Final health: ");
+        }
+        out = append_int(out, health);
+        *out++ = '\n';
+    }
+    log->used[log->current] += out - start;
+}
+
+int log_close(GladiatorLog* log)
+{
+    int result = log_flush(log) == -1 || log->failed ? -1 : 0;
+    free(log->ring);
+    log->ring = NULL;
+    if (log->fd > STDERR_FILENO && close(log->fd) == -1)
+    {
+        perror("close");
+        result = -1;
+    }
+    return result;
+}
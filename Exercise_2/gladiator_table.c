@@ -0,0 +1,312 @@
+// stats table shared by tournament.c and gladiator.c
+//
+// the tournament parses every G<n>.txt file once into a struct of arrays and
+// publishes it to the gladiator processes as a sealed, read-only memfd mapping.
+// the fd number is passed through the GLADIATOR_TABLE_FD environment variable.
+// a gladiator started without the table (e.g. by hand) preloads the stats it needs itself.
+//
+// mapping layout (all ints):
+//   count, total_opponents
+//   health[count]
+//   attack[count]
+//   opponents_start[count + 1]   opponents of i: opponents[opponents_start[i] .. opponents_start[i + 1])
+//   opponents[total_opponents]   gladiator numbers (1-based, like in the stats files)
+
+// the including file must define _GNU_SOURCE before its first include (memfd_create)
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define GLADIATOR_TABLE_ENV "GLADIATOR_TABLE_FD"
+#define GLADIATOR_TABLE_HEADER 2
+#define GLADIATOR_FILENAME_LEN 256
+
+typedef struct
+{
+    int count;
+    int total_opponents;
+    int* health;
+    int* attack;
+    int* opponents_start;
+    int* opponents;
+    int* mapping;       // the whole table, read-only once published
+    size_t mapping_size;
+    int fd;
+} GladiatorTable;
+
+// read stats from file
+
+void get_gladiator_filename(const char* glad_name, char* filename, size_t size) {
+    snprintf(filename, size, "%s.txt", glad_name);
+}
+
+// parse "Health, Attack, Opponent1, Opponent2, ..." from "<glad_name>.txt".
+// opponents are appended to *opponents (grown with realloc), returns the number
+// of opponents read or -1 if the file can't be opened or is malformed.
+int parse_gladiator_stats(const char* glad_name, int* health, int* attack, int** opponents, int* opponents_len,
+                          int* opponents_cap)
+{
+    char filename[GLADIATOR_FILENAME_LEN];
+    get_gladiator_filename(glad_name, filename, sizeof(filename));
+
+    FILE *file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        perror("Error opening file");
+        return -1;
+    }
+    char* line = NULL;
+    size_t line_cap = 0;
+    ssize_t line_len = getline(&line, &line_cap, file);
+    fclose(file);
+    if (line_len <= 0)
+    {
+        free(line);
+        fprintf(stderr, "Invalid stats in %s\n", filename);
+        return -1;
+    }
+
+    int fields = 0;
+    char* cursor = line;
+    while (1)
+    {
+        while (*cursor == ' ' || *cursor == '\t' || *cursor == ',')
+        {
+            cursor++;
+        }
+        if (*cursor == '\0' || *cursor == '\n' || *cursor == '\r')
+        {
+            break;
+        }
+        char* end;
+        long value = strtol(cursor, &end, 10);
+        if (end == cursor)
+        {
+            break;
+        }
+        cursor = end;
+
+        if (fields == 0) {
+            *health = value;
+        } else if (fields == 1) {
+            *attack = value;
+        } else {
+            if (*opponents_len == *opponents_cap)
+            {
+                *opponents_cap = *opponents_cap ? *opponents_cap * 2 : 16;
+                int* grown = realloc(*opponents, *opponents_cap * sizeof(int));
+                if (grown == NULL)
+                {
+                    perror("realloc");
+                    free(line);
+                    return -1;
+                }
+                *opponents = grown;
+            }
+            (*opponents)[(*opponents_len)++] = value;
+        }
+        fields++;
+    }
+    free(line);
+
+    if (fields < 2)
+    {
+        fprintf(stderr, "Invalid stats in %s\n", filename);
+        return -1;
+    }
+    return fields - 2;
+}
+
+// attack power of gladiator number glad_no (1-based), 0 if there is no such gladiator
+// (a gladiator takes 0 damage from an opponent whose file can't be opened)
+int table_attack(const GladiatorTable* table, int glad_no)
+{
+    if (glad_no < 1 || glad_no > table->count)
+    {
+        return 0;
+    }
+    return table->attack[glad_no - 1];
+}
+
+int table_num_opponents(const GladiatorTable* table, int index)
+{
+    return table->opponents_start[index + 1] - table->opponents_start[index];
+}
+
+const int* table_opponents(const GladiatorTable* table, int index)
+{
+    return table->opponents + table->opponents_start[index];
+}
+
+void table_point_arrays(GladiatorTable* table, int* base)
+{
+    table->mapping = base;
+    table->count = base[0];
+    table->total_opponents = base[1];
+    table->health = base + GLADIATOR_TABLE_HEADER;
+    table->attack = table->health + table->count;
+    table->opponents_start = table->attack + table->count;
+    table->opponents = table->opponents_start + table->count + 1;
+}
+
+size_t table_size(int count, int total_opponents)
+{
+    return ((size_t)GLADIATOR_TABLE_HEADER + 3 * (size_t)count + 1 + total_opponents) * sizeof(int);
+}
+
+// parse all stats files once into a memfd backed table.
+// a gladiator whose file can't be read gets 0 health, 0 attack and no opponents,
+// which is what gladiator.c does on its own in that case.
+int table_build(GladiatorTable* table, char** glad_files, int count)
+{
+    int* health = malloc(count * sizeof(int));
+    int* attack = malloc(count * sizeof(int));
+    int* opponents_start = malloc((count + 1) * sizeof(int));
+    int* opponents = NULL;
+    int opponents_len = 0, opponents_cap = 0;
+    if (health == NULL || attack == NULL || opponents_start == NULL)
+    {
+        perror("malloc");
+        free(health);
+        free(attack);
+        free(opponents_start);
+        return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        opponents_start[i] = opponents_len;
+        if (parse_gladiator_stats(glad_files[i], &health[i], &attack[i], &opponents, &opponents_len,
+                                  &opponents_cap) == -1)
+        {
+            health[i] = 0;
+            attack[i] = 0;
+            opponents_len = opponents_start[i];
+        }
+    }
+    opponents_start[count] = opponents_len;
+
+    int result = -1;
+    int* base;
+    size_t size = table_size(count, opponents_len);
+    int fd = memfd_create("gladiator_table", MFD_ALLOW_SEALING);
+    if (fd == -1)
+    {
+        perror("memfd_create");
+        goto out;
+    }
+    if (ftruncate(fd, size) == -1)
+    {
+        perror("ftruncate");
+        close(fd);
+        goto out;
+    }
+    base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+    {
+        perror("mmap");
+        close(fd);
+        goto out;
+    }
+    base[0] = count;
+    base[1] = opponents_len;
+    table_point_arrays(table, base);
+    memcpy(table->health, health, count * sizeof(int));
+    memcpy(table->attack, attack, count * sizeof(int));
+    memcpy(table->opponents_start, opponents_start, (count + 1) * sizeof(int));
+    if (opponents_len > 0)
+    {
+        memcpy(table->opponents, opponents, opponents_len * sizeof(int));
+    }
+    munmap(base, size);
+
+    // nobody (including us) can modify the table from now on
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1)
+    {
+        perror("fcntl F_ADD_SEALS");
+        close(fd);
+        goto out;
+    }
+    base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+    {
+        perror("mmap");
+        close(fd);
+        goto out;
+    }
+    table_point_arrays(table, base);
+    table->mapping_size = size;
+    table->fd = fd;
+    result = 0;
+
+out:
+    free(health);
+    free(attack);
+    free(opponents_start);
+    free(opponents);
+    return result;
+}
+
+// let children find the table: the memfd is inherited across exec
+int table_publish(const GladiatorTable* table)
+{
+    char fd_str[16];
+    snprintf(fd_str, sizeof(fd_str), "%d", table->fd);
+    if (setenv(GLADIATOR_TABLE_ENV, fd_str, 1) == -1)
+    {
+        perror("setenv");
+        return -1;
+    }
+    return 0;
+}
+
+// map the table published by the tournament, returns -1 if there is none
+int table_attach(GladiatorTable* table)
+{
+    const char* fd_str = getenv(GLADIATOR_TABLE_ENV);
+    if (fd_str == NULL)
+    {
+        return -1;
+    }
+    int fd = atoi(fd_str);
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < table_size(0, 0))
+    {
+        return -1;
+    }
+    int* base = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED)
+    {
+        perror("mmap");
+        return -1;
+    }
+    if (base[0] < 0 || base[1] < 0 || table_size(base[0], base[1]) != (size_t)st.st_size)
+    {
+        fprintf(stderr, "Invalid gladiator table\n");
+        munmap(base, st.st_size);
+        return -1;
+    }
+    table_point_arrays(table, base);
+    table->mapping_size = st.st_size;
+    table->fd = fd;
+    return 0;
+}
+
+void table_destroy(GladiatorTable* table)
+{
+    if (table->mapping != NULL)
+    {
+        munmap(table->mapping, table->mapping_size);
+        table->mapping = NULL;
+    }
+    if (table->fd >= 0)
+    {
+        close(table->fd);
+        table->fd = -1;
+    }
+}
@@ -0,0 +1,64 @@
+// print a binary gladiator log (G*_log.bin) in the text format of G*_log.txt
+// usage: ./log_printer G1_log.bin [G1_log.txt]   (stdout if no output file is given)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "gladiator_log.c"
+
+#define RECORDS_PER_READ 4096
+
+int main(int argc, char const *argv[])
+{
+    if (argc != 2 && argc != 3)
+    {
+        fprintf(stderr, "Usage: %s <binary_log> [<text_log>]\n", argv[0]);
+        return 1;
+    }
+
+    FILE* input = fopen(argv[1], "rb");
+    if (input == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    char magic[4];
+    int header[2];
+    if (fread(magic, 1, sizeof(magic), input) != sizeof(magic) || memcmp(magic, LOG_MAGIC, sizeof(magic)) != 0 ||
+        fread(header, sizeof(int), 2, input) != 2 || header[0] != LOG_VERSION)
+    {
+        fprintf(stderr, "%s: not a binary gladiator log\n", argv[1]);
+        fclose(input);
+        return 1;
+    }
+
+    GladiatorLog text_log;
+    int opened = argc == 3 ? log_open(&text_log, argv[2], 0) : log_open_fd(&text_log, STDOUT_FILENO, 0);
+    if (opened == -1)
+    {
+        fclose(input);
+        return 1;
+    }
+
+    log_started(&text_log, header[1]);
+    LogRecord records[RECORDS_PER_READ];
+    size_t count;
+    while ((count = fread(records, sizeof(LogRecord), RECORDS_PER_READ, input)) > 0)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            log_hit(&text_log, records[i].opponent, records[i].damage, records[i].health);
+        }
+    }
+    int read_error = ferror(input);
+    fclose(input);
+
+    if (log_close(&text_log) == -1 || read_error)
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,245 @@
+import argparse
+import os
+import random
+import shutil
+import string
+import subprocess
+import sys
+import tempfile
+import time
+
+# Benchmark generator and differential fuzzer for file_processor.
+#
+# bench mode: generate a large data file and a request stream, run the program once
+#             and report requests per second, bytes moved and peak RSS.
+# diff mode:  run many small random cases (including out-of-range requests) and
+#             compare the program against the reference semantics of the original
+#             read_data/write_data, or against another binary (--reference).
+
+PROGRAM_NAME = './file_processor'
+DATA_FILE = 'data.txt'
+REQUESTS_FILE = 'requests.txt'
+RESULTS_FILE = 'read_results.txt'
+
+# file_processor reads at most BUFFER_SIZE bytes per R command and scans W payloads
+# into a BUFFER_SIZE buffer, so payloads are limited to BUFFER_SIZE - 1 characters.
+BUFFER_SIZE = 256
+ALPHABET = string.ascii_letters + string.digits
+
+# reference semantics
+
+
+def reference_read(data, start, end):
+    """Mirror read_data(): returns the text appended to read_results.txt (or None)."""
+    if start < 0 or end < start or end > len(data):
+        return None
+    length = min(end - start + 1, BUFFER_SIZE)
+    chunk = data[start:start + length]
+    if not chunk:
+        # fread returns 0 bytes when start == file size
+        return None
+    return chunk + '\n'
+
+
+def reference_write(data, offset, payload):
+    """Mirror write_data(): returns the new data (or None when the offset is rejected)."""
+    if offset < 0 or offset > len(data):
+        return None
+    return data[:offset] + payload + data[offset:]
+
+
+def reference_run(data, requests):
+    """Apply a request list to data, returns (data_after, read_results, stats)."""
+    results = []
+    stats = {'reads': 0, 'writes': 0, 'rejected': 0, 'read_bytes': 0, 'write_bytes': 0, 'shifted_bytes': 0}
+    for request in requests:
+        if request[0] == 'Q':
+            break
+        if request[0] == 'R':
+            out = reference_read(data, request[1], request[2])
+            if out is None:
+                stats['rejected'] += 1
+                continue
+            stats['reads'] += 1
+            stats['read_bytes'] += len(out) - 1
+            results.append(out)
+        else:
+            new_data = reference_write(data, request[1], request[2])
+            if new_data is None:
+                stats['rejected'] += 1
+                continue
+            stats['writes'] += 1
+            stats['write_bytes'] += len(request[2])
+            stats['shifted_bytes'] += len(data) - request[1]
+            data = new_data
+    return data, ''.join(results), stats
+
+# generators
+
+
+def random_text(rng, length):
+    return ''.join(rng.choice(ALPHABET) for _ in range(length))
+
+
+def pick_offset(rng, size, distribution):
+    if size == 0:
+        return 0
+    if distribution == 'append':
+        # most requests hit the last few percent of the file
+        return max(0, size - int(rng.expovariate(1.0) * max(1, size // 100)))
+    if distribution == 'prefix':
+        return min(size, int(rng.expovariate(1.0) * max(1, size // 100)))
+    return rng.randint(0, size)
+
+
+def generate_requests(rng, size, count, read_ratio, distribution, payload, invalid_ratio=0.0):
+    """Generate count requests while tracking the file size the program will see."""
+    requests = []
+    for _ in range(count):
+        invalid = rng.random() < invalid_ratio
+        if rng.random() < read_ratio:
+            start = pick_offset(rng, size, distribution)
+            end = start + rng.randint(0, 2 * BUFFER_SIZE)
+            if invalid:
+                start, end = rng.choice([(-1 - start, end), (start, start - 1 - rng.randint(0, 5)),
+                                         (start, size + 1 + rng.randint(0, 10)), (size, size)])
+            else:
+                end = min(end, size)
+            requests.append(('R', start, end))
+        else:
+            offset = pick_offset(rng, size, distribution)
+            text = random_text(rng, rng.randint(1, payload))
+            if invalid:
+                offset = rng.choice([-1 - offset, size + 1 + rng.randint(0, 10)])
+            else:
+                size += len(text)
+            requests.append(('W', offset, text))
+    requests.append(('Q',))
+    return requests
+
+
+def format_requests(requests):
+    lines = []
+    for request in requests:
+        lines.append(' '.join(str(field) for field in request))
+    return '\n'.join(lines) + '\n'
+
+# running
+
+
+def run_program(program, work_dir, data, requests_text):
+    """Run program in work_dir, returns (data_after, read_results, seconds, peak_rss_kb)."""
+    with open(os.path.join(work_dir, DATA_FILE), 'w') as f:
+        f.write(data)
+    with open(os.path.join(work_dir, REQUESTS_FILE), 'w') as f:
+        f.write(requests_text)
+
+    start = time.perf_counter()
+    process = subprocess.Popen([os.path.abspath(program), DATA_FILE, REQUESTS_FILE], cwd=work_dir,
+                               stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    _, status, rusage = os.wait4(process.pid, 0)
+    elapsed = time.perf_counter() - start
+    process.returncode = os.waitstatus_to_exitcode(status)
+
+    with open(os.path.join(work_dir, DATA_FILE), 'r') as f:
+        data_after = f.read()
+    with open(os.path.join(work_dir, RESULTS_FILE), 'r') as f:
+        read_results = f.read()
+    return data_after, read_results, elapsed, rusage.ru_maxrss
+
+
+def bench(args):
+    rng = random.Random(args.seed)
+    data = random_text(rng, args.data_size)
+    requests = generate_requests(rng, len(data), args.requests, args.read_ratio, args.offsets, args.payload)
+    requests_text = format_requests(requests)
+    _, _, stats = reference_run(data, requests)
+
+    work_dir = tempfile.mkdtemp(prefix='file_processor_bench_')
+    try:
+        _, _, elapsed, peak_rss = run_program(args.program, work_dir, data, requests_text)
+    finally:
+        shutil.rmtree(work_dir)
+
+    moved = stats['read_bytes'] + stats['write_bytes'] + stats['shifted_bytes']
+    print(f"data size        : {args.data_size} bytes")
+    print(f"requests         : {args.requests} (read ratio {args.read_ratio:.2f}, {args.offsets} offsets, "
+          f"payload <= {args.payload})")
+    print(f"elapsed          : {elapsed:.3f} s")
+    print(f"requests / sec   : {args.requests / elapsed:.0f}")
+    print(f"bytes read       : {stats['read_bytes']}")
+    print(f"bytes inserted   : {stats['write_bytes']}")
+    print(f"bytes shifted    : {stats['shifted_bytes']}")
+    print(f"bytes moved / sec: {moved / elapsed:.0f}")
+    print(f"peak RSS         : {peak_rss} KB")
+    return 0
+
+
+def diff(args):
+    rng = random.Random(args.seed)
+    failures = 0
+    work_dir = tempfile.mkdtemp(prefix='file_processor_diff_')
+    reference_dir = tempfile.mkdtemp(prefix='file_processor_ref_')
+    try:
+        for case in range(1, args.cases + 1):
+            data = random_text(rng, rng.randint(0, 64))
+            requests = generate_requests(rng, len(data), rng.randint(1, 20), args.read_ratio,
+                                         rng.choice(['uniform', 'append', 'prefix']), args.payload,
+                                         invalid_ratio=0.3)
+            requests_text = format_requests(requests)
+
+            if args.reference:
+                expected_data, expected_results, _, _ = run_program(args.reference, reference_dir, data,
+                                                                    requests_text)
+            else:
+                expected_data, expected_results, _ = reference_run(data, requests)
+            actual_data, actual_results, _, _ = run_program(args.program, work_dir, data, requests_text)
+
+            if actual_data != expected_data or actual_results != expected_results:
+                failures += 1
+                print(f"\n❌ Case {case} failed")
+                print(f"data:\n{data}\nrequests:\n{requests_text}")
+                if actual_data != expected_data:
+                    print(f"--- Expected data.txt:\n{expected_data}\n+++ Actual data.txt:\n{actual_data}")
+                if actual_results != expected_results:
+                    print(f"--- Expected read_results.txt:\n{expected_results}\n"
+                          f"+++ Actual read_results.txt:\n{actual_results}")
+                if failures >= args.max_failures:
+                    break
+    finally:
+        shutil.rmtree(work_dir)
+        shutil.rmtree(reference_dir)
+
+    if failures == 0:
+        print(f"✅ {args.cases} random cases match the reference")
+        return 0
+    return 1
+
+
+def main():
+    parser = argparse.ArgumentParser(description='file_processor benchmark and differential fuzzer')
+    parser.add_argument('mode', choices=['bench', 'diff'])
+    parser.add_argument('--program', default=PROGRAM_NAME, help='binary under test')
+    parser.add_argument('--reference', help='diff against this binary instead of the built-in model')
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--data-size', type=int, default=1 << 20, help='initial data file size in bytes')
+    parser.add_argument('--requests', type=int, default=10000)
+    parser.add_argument('--read-ratio', type=float, default=0.5, help='fraction of R requests')
+    parser.add_argument('--offsets', choices=['uniform', 'append', 'prefix'], default='uniform')
+    parser.add_argument('--payload', type=int, default=32, help='max W payload length')
+    parser.add_argument('--cases', type=int, default=500, help='number of random cases in diff mode')
+    parser.add_argument('--max-failures', type=int, default=5)
+    args = parser.parse_args()
+
+    if not 1 <= args.payload < BUFFER_SIZE:
+        parser.error(f'--payload must be between 1 and {BUFFER_SIZE - 1}')
+    if not os.access(args.program, os.X_OK):
+        parser.error(f"program '{args.program}' not found or not executable")
+
+    if args.mode == 'bench':
+        return bench(args)
+    return diff(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
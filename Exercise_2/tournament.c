@@ -1,56 +1,1209 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <spawn.h>
+#include <stdint.h>
+#include <time.h>
 #include <unistd.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 
+#include "gladiator_table.c"
+#include "gladiator_log.c"
+
 #define NUM_GLADIATORS 4
+#define ROSTER_LINE_LEN 512
+#define MONTE_CARLO_BATCH 1024
+
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
 
+extern char **environ;
 
 char* gladiator_names[NUM_GLADIATORS] = {"Maximus", "Lucius", "Commodus", "Spartacus"};
 char* gladiator_files[NUM_GLADIATORS] = {"G1", "G2", "G3", "G4"};
 
-// fork a child for each glidator
-// use exec to launch a process for each gladiator (pass matching gladiator file name as an argument)
+// the gladiators of a tournament, in order. opponent number n in a stats file
+// refers to the n-th gladiator of the roster (G<n> for the default roster).
+typedef struct
+{
+    int count;
+    char** names;
+    char** files;
+} Roster;
 
-// wait for the child process to complete and determine the winner based
-// on whose gladiator process terminated last
+void default_roster(Roster* roster)
+{
+    roster->count = NUM_GLADIATORS;
+    roster->names = gladiator_names;
+    roster->files = gladiator_files;
+}
 
+// frees a roster built by load_roster
+void free_loaded_roster(Roster* roster)
+{
+    for (int i = 0; i < roster->count; i++)
+    {
+        free(roster->names[i]);
+        free(roster->files[i]);
+    }
+    free(roster->names);
+    free(roster->files);
+    roster->count = 0;
+}
 
-int main()
+// roster file: one "Name, File" line per gladiator, lines starting with '#' are skipped
+int load_roster(const char* filename, Roster* roster)
 {
-    int gladiator_pids[NUM_GLADIATORS];
+    FILE* file = fopen(filename, "r");
+    if (file == NULL)
+    {
+        perror("Error opening roster file");
+        return -1;
+    }
+    int capacity = 16;
+    roster->count = 0;
+    roster->names = malloc(capacity * sizeof(char*));
+    roster->files = malloc(capacity * sizeof(char*));
+    if (roster->names == NULL || roster->files == NULL)
+    {
+        perror("malloc");
+        fclose(file);
+        return -1;
+    }
 
-    for (int i = 0; i < NUM_GLADIATORS; i++)
+    char line[ROSTER_LINE_LEN];
+    char name[ROSTER_LINE_LEN], glad_file[ROSTER_LINE_LEN];
+    int line_no = 0;
+    while (fgets(line, sizeof(line), file))
     {
-        gladiator_pids[i] = fork();
-        if (gladiator_pids[i] == 0)
+        line_no++;
+        if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
         {
-            // use execvp to launch a process for each gladiator
-            char *args[] = {"./gladiator", gladiator_files[i], NULL};
-            execvp(args[0], args);
-            perror("execvp failed");
-            exit(EXIT_FAILURE);
+            continue;
         }
+        if (sscanf(line, " %[^,], %s", name, glad_file) != 2)
+        {
+            fprintf(stderr, "%s:%d: expected \"Name, File\"\n", filename, line_no);
+            fclose(file);
+            return -1;
+        }
+        if (roster->count == capacity)
+        {
+            capacity *= 2;
+            char** names = realloc(roster->names, capacity * sizeof(char*));
+            char** files = names ? realloc(roster->files, capacity * sizeof(char*)) : NULL;
+            if (files == NULL)
+            {
+                perror("realloc");
+                fclose(file);
+                return -1;
+            }
+            roster->names = names;
+            roster->files = files;
+        }
+        char* name_copy = strdup(name);
+        char* file_copy = strdup(glad_file);
+        if (name_copy == NULL || file_copy == NULL)
+        {
+            perror("strdup");
+            free(name_copy);
+            free(file_copy);
+            free_loaded_roster(roster);
+            fclose(file);
+            return -1;
+        }
+        roster->names[roster->count] = name_copy;
+        roster->files[roster->count] = file_copy;
+        roster->count++;
     }
+    fclose(file);
 
-    // wait for all gladiators to finish
-    int winner_index = -1;
-    
-    // Get gladiators in order of termination 
-    for (int i = 0; i < NUM_GLADIATORS; i++) {
-        int status;
-        // only the last pid w
-        pid_t terminated_pid = wait(&status);
-        
-        for (int j = 0; j < NUM_GLADIATORS; j++) {
-            if (gladiator_pids[j] == terminated_pid) {
-                winner_index = j;
+    if (roster->count == 0)
+    {
+        fprintf(stderr, "%s: no gladiators\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
+// pid -> roster index, open addressing with linear probing.
+// only running children are stored, so it stays small and lookups are O(1).
+typedef struct
+{
+    pid_t* pids; // 0 marks an empty slot
+    int* indices;
+    unsigned int mask;
+} PidMap;
+
+int pidmap_init(PidMap* map, int max_entries)
+{
+    unsigned int capacity = 16;
+    while (capacity < 2 * (unsigned int)max_entries)
+    {
+        capacity *= 2;
+    }
+    map->mask = capacity - 1;
+    map->pids = calloc(capacity, sizeof(pid_t));
+    map->indices = malloc(capacity * sizeof(int));
+    if (map->pids == NULL || map->indices == NULL)
+    {
+        perror("malloc");
+        return -1;
+    }
+    return 0;
+}
+
+unsigned int pidmap_slot(const PidMap* map, pid_t pid)
+{
+    return ((unsigned int)pid * 2654435761u) & map->mask;
+}
+
+void pidmap_put(PidMap* map, pid_t pid, int index)
+{
+    unsigned int slot = pidmap_slot(map, pid);
+    while (map->pids[slot] != 0)
+    {
+        slot = (slot + 1) & map->mask;
+    }
+    map->pids[slot] = pid;
+    map->indices[slot] = index;
+}
+
+// remove pid and return its index, -1 if it isn't ours
+int pidmap_take(PidMap* map, pid_t pid)
+{
+    unsigned int slot = pidmap_slot(map, pid);
+    while (map->pids[slot] != pid)
+    {
+        if (map->pids[slot] == 0)
+        {
+            return -1;
+        }
+        slot = (slot + 1) & map->mask;
+    }
+    int index = map->indices[slot];
+
+    // backward shift deletion keeps probe chains intact without tombstones
+    unsigned int hole = slot;
+    unsigned int next = (slot + 1) & map->mask;
+    while (map->pids[next] != 0)
+    {
+        unsigned int home = pidmap_slot(map, map->pids[next]);
+        if (((next - home) & map->mask) >= ((next - hole) & map->mask))
+        {
+            map->pids[hole] = map->pids[next];
+            map->indices[hole] = map->indices[next];
+            hole = next;
+        }
+        next = (next + 1) & map->mask;
+    }
+    map->pids[hole] = 0;
+    return index;
+}
+
+void pidmap_destroy(PidMap* map)
+{
+    free(map->pids);
+    free(map->indices);
+}
+
+double monotonic_seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// spawn a child for each glidator
+// posix_spawn launches a process for each gladiator (pass matching gladiator file name as an argument)
+// at most `jobs` gladiators run at once, so a big roster can't fork-bomb the host
+
+// wait for the child processes to complete and determine the winner based on
+// whose gladiator process stayed alive the longest. when all gladiators run at
+// once this is the one that terminated last.
+
+// children are supervised through pidfds in an epoll set, which also lets us
+// enforce per-gladiator timeouts. kernels without pidfd_open fall back to wait4().
+
+typedef struct
+{
+    int jobs;
+    double timeout;          // seconds per gladiator, 0 for no limit
+    const char* report_file; // JSON if it ends with ".json", CSV otherwise
+} SupervisionOptions;
+
+// what we learn about each gladiator process, times are seconds since the tournament started
+typedef struct
+{
+    pid_t pid;
+    int pidfd;
+    double started;
+    double ended;
+    double user_cpu;
+    double system_cpu;
+    long max_rss_kb;
+    int status;
+    int timed_out;
+} GladiatorRun;
+
+typedef struct
+{
+    const Roster* roster;
+    const SupervisionOptions* options;
+    GladiatorRun* runs;
+    double epoch;
+    int next;      // next roster index to spawn
+    int* running;  // roster indices of the running children
+    int num_running;
+} Supervisor;
+
+int sys_pidfd_open(pid_t pid)
+{
+    return syscall(SYS_pidfd_open, pid, 0);
+}
+
+int sys_pidfd_send_signal(int pidfd, int sig)
+{
+    return syscall(SYS_pidfd_send_signal, pidfd, sig, NULL, 0);
+}
+
+double supervisor_now(const Supervisor* supervisor)
+{
+    return monotonic_seconds() - supervisor->epoch;
+}
+
+pid_t spawn_gladiator(const Roster* roster, int index)
+{
+    char glad_no[16];
+    snprintf(glad_no, sizeof(glad_no), "%d", index + 1);
+    char *args[] = {"./gladiator", roster->files[index], glad_no, NULL};
+    pid_t pid;
+    int error = posix_spawn(&pid, args[0], NULL, NULL, args, environ);
+    if (error != 0)
+    {
+        errno = error;
+        perror("posix_spawn failed");
+        return -1;
+    }
+    return pid;
+}
+
+// spawn the next gladiator, returns its index or -1
+int start_next(Supervisor* supervisor)
+{
+    int index = supervisor->next;
+    GladiatorRun* run = &supervisor->runs[index];
+    run->started = supervisor_now(supervisor);
+    run->pid = spawn_gladiator(supervisor->roster, index);
+    if (run->pid == -1)
+    {
+        return -1;
+    }
+    supervisor->next++;
+    supervisor->running[supervisor->num_running++] = index;
+    return index;
+}
+
+// take a gladiator out of the running set
+void forget_run(Supervisor* supervisor, int index)
+{
+    supervisor->runs[index].ended = supervisor_now(supervisor);
+    for (int i = 0; i < supervisor->num_running; i++)
+    {
+        if (supervisor->running[i] == index)
+        {
+            supervisor->running[i] = supervisor->running[--supervisor->num_running];
+            break;
+        }
+    }
+}
+
+void record_exit(Supervisor* supervisor, int index, int status, const struct rusage* usage)
+{
+    GladiatorRun* run = &supervisor->runs[index];
+    run->status = status;
+    run->user_cpu = usage->ru_utime.tv_sec + usage->ru_utime.tv_usec / 1e6;
+    run->system_cpu = usage->ru_stime.tv_sec + usage->ru_stime.tv_usec / 1e6;
+    run->max_rss_kb = usage->ru_maxrss;
+    forget_run(supervisor, index);
+}
+
+// reap one gladiator. if it can't be waited for it's still dropped from the running set
+// (without an exit status), so the supervision loop doesn't wait for it forever
+int wait_for_run(Supervisor* supervisor, int index)
+{
+    int status;
+    struct rusage usage;
+    while (wait4(supervisor->runs[index].pid, &status, 0, &usage) == -1)
+    {
+        if (errno != EINTR)
+        {
+            perror("wait4");
+            forget_run(supervisor, index);
+            return -1;
+        }
+    }
+    record_exit(supervisor, index, status, &usage);
+    return 0;
+}
+
+// milliseconds until the earliest running gladiator times out, -1 to wait forever
+int next_timeout_ms(const Supervisor* supervisor)
+{
+    if (supervisor->options->timeout <= 0)
+    {
+        return -1;
+    }
+    double now = supervisor_now(supervisor);
+    double earliest = -1;
+    for (int i = 0; i < supervisor->num_running; i++)
+    {
+        const GladiatorRun* run = &supervisor->runs[supervisor->running[i]];
+        if (run->timed_out)
+        {
+            continue;
+        }
+        double left = run->started + supervisor->options->timeout - now;
+        if (earliest < 0 || left < earliest)
+        {
+            earliest = left < 0 ? 0 : left;
+        }
+    }
+    return earliest < 0 ? -1 : (int)(earliest * 1000) + 1;
+}
+
+void kill_timed_out(Supervisor* supervisor)
+{
+    if (supervisor->options->timeout <= 0)
+    {
+        return;
+    }
+    double now = supervisor_now(supervisor);
+    for (int i = 0; i < supervisor->num_running; i++)
+    {
+        GladiatorRun* run = &supervisor->runs[supervisor->running[i]];
+        if (!run->timed_out && now - run->started >= supervisor->options->timeout)
+        {
+            // the exit is reported through the pidfd like any other
+            if (sys_pidfd_send_signal(run->pidfd, SIGKILL) == -1 && errno != ESRCH)
+            {
+                perror("pidfd_send_signal");
+            }
+            run->timed_out = 1;
+        }
+    }
+}
+
+// returns 0 when done, -1 on error, 1 if pidfds are not supported
+int supervise_with_pidfd(Supervisor* supervisor)
+{
+    int probe = sys_pidfd_open(getpid());
+    if (probe == -1)
+    {
+        return 1;
+    }
+    close(probe);
+
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd == -1)
+    {
+        perror("epoll_create1");
+        return -1;
+    }
+
+    int count = supervisor->roster->count;
+    int result = 0;
+    struct epoll_event events[64];
+    while (supervisor->next < count || supervisor->num_running > 0)
+    {
+        while (result == 0 && supervisor->num_running < supervisor->options->jobs && supervisor->next < count)
+        {
+            int index = start_next(supervisor);
+            if (index == -1)
+            {
+                // stop spawning, but still reap the ones already running
+                result = -1;
                 break;
             }
+            GladiatorRun* run = &supervisor->runs[index];
+            run->pidfd = sys_pidfd_open(run->pid);
+            struct epoll_event event = {.events = EPOLLIN, .data.u32 = index};
+            if (run->pidfd == -1 || epoll_ctl(epfd, EPOLL_CTL_ADD, run->pidfd, &event) == -1)
+            {
+                perror("pidfd_open/epoll_ctl");
+                // it can't be watched: wait for it here, and for the others in the loop below
+                if (run->pidfd != -1)
+                {
+                    close(run->pidfd);
+                    run->pidfd = -1;
+                }
+                wait_for_run(supervisor, index);
+                result = -1;
+                break;
+            }
+        }
+        if (supervisor->num_running == 0)
+        {
+            break;
+        }
+
+        int ready = epoll_wait(epfd, events, 64, next_timeout_ms(supervisor));
+        if (ready == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("epoll_wait");
+            result = -1;
+            break;
         }
+        for (int i = 0; i < ready; i++)
+        {
+            int index = events[i].data.u32;
+            GladiatorRun* run = &supervisor->runs[index];
+            if (wait_for_run(supervisor, index) == -1)
+            {
+                result = -1;
+            }
+            epoll_ctl(epfd, EPOLL_CTL_DEL, run->pidfd, NULL);
+            close(run->pidfd);
+            run->pidfd = -1;
+        }
+        kill_timed_out(supervisor);
     }
-    printf("The gods have spoken, the winner of the tournament is %s!\n", gladiator_names[winner_index]);
+    close(epfd);
+    return result;
+}
 
+// no pidfds: wait4() on any child and map the pid back to its index
+int supervise_with_wait(Supervisor* supervisor)
+{
+    if (supervisor->options->timeout > 0)
+    {
+        fprintf(stderr, "pidfd_open is not supported, gladiator timeouts are ignored\n");
+    }
+    PidMap running_map;
+    if (pidmap_init(&running_map, supervisor->options->jobs) == -1)
+    {
+        return -1;
+    }
+
+    int count = supervisor->roster->count;
+    int result = 0;
+    while (supervisor->next < count || supervisor->num_running > 0)
+    {
+        while (result == 0 && supervisor->num_running < supervisor->options->jobs && supervisor->next < count)
+        {
+            int index = start_next(supervisor);
+            if (index == -1)
+            {
+                result = -1;
+                break;
+            }
+            pidmap_put(&running_map, supervisor->runs[index].pid, index);
+        }
+        if (supervisor->num_running == 0)
+        {
+            break;
+        }
+
+        int status;
+        struct rusage usage;
+        pid_t terminated_pid = wait4(-1, &status, 0, &usage);
+        if (terminated_pid == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("wait4");
+            result = -1;
+            break;
+        }
+        int index = pidmap_take(&running_map, terminated_pid);
+        if (index != -1)
+        {
+            record_exit(supervisor, index, status, &usage);
+        }
+    }
+    pidmap_destroy(&running_map);
+    return result;
+}
+
+// report
+
+void write_json_string(FILE* file, const char* str)
+{
+    fputc('"', file);
+    for (; *str; str++)
+    {
+        if (*str == '"' || *str == '\\') {
+            fprintf(file, "\\%c", *str);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(file, "\\u%04x", *str);
+        } else {
+            fputc(*str, file);
+        }
+    }
+    fputc('"', file);
+}
+
+void write_csv_string(FILE* file, const char* str)
+{
+    fputc('"', file);
+    for (; *str; str++)
+    {
+        if (*str == '"') {
+            fputc('"', file);
+        }
+        fputc(*str, file);
+    }
+    fputc('"', file);
+}
+
+int write_report(const Supervisor* supervisor, int winner_index, double wall_time)
+{
+    const char* filename = supervisor->options->report_file;
+    size_t len = strlen(filename);
+    int json = len >= 5 && strcmp(filename + len - 5, ".json") == 0;
+    FILE* file = fopen(filename, "w");
+    if (file == NULL)
+    {
+        perror("Error opening report file");
+        return -1;
+    }
+
+    const Roster* roster = supervisor->roster;
+    if (json)
+    {
+        fprintf(file, "{\n  \"gladiators\": %d,\n  \"jobs\": %d,\n  \"wall_time\": %.6f,\n  \"winner\": ",
+                roster->count, supervisor->options->jobs, wall_time);
+        if (winner_index == -1) {
+            fprintf(file, "null");
+        } else {
+            write_json_string(file, roster->names[winner_index]);
+        }
+        fprintf(file, ",\n  \"timeline\": [\n");
+    }
+    else
+    {
+        fprintf(file, "index,name,file,pid,start,end,wall,user_cpu,system_cpu,max_rss_kb,exit_status,signal,timed_out\n");
+    }
+
+    for (int i = 0; i < roster->count; i++)
+    {
+        const GladiatorRun* run = &supervisor->runs[i];
+        int exit_status = WIFEXITED(run->status) ? WEXITSTATUS(run->status) : -1;
+        int signal_no = WIFSIGNALED(run->status) ? WTERMSIG(run->status) : 0;
+        if (json)
+        {
+            fprintf(file, "    {\"index\": %d, \"name\": ", i + 1);
+            write_json_string(file, roster->names[i]);
+            fprintf(file, ", \"file\": ");
+            write_json_string(file, roster->files[i]);
+            fprintf(file, ", \"pid\": %d, \"start\": %.6f, \"end\": %.6f, \"wall\": %.6f, \"user_cpu\": %.6f, "
+                          "\"system_cpu\": %.6f, \"max_rss_kb\": %ld, \"exit_status\": %d, \"signal\": %d, "
+                          "\"timed_out\": %s}%s\n",
+                    run->pid, run->started, run->ended, run->ended - run->started, run->user_cpu, run->system_cpu,
+                    run->max_rss_kb, exit_status, signal_no, run->timed_out ? "true" : "false",
+                    i + 1 < roster->count ? "," : "");
+        }
+        else
+        {
+            fprintf(file, "%d,", i + 1);
+            write_csv_string(file, roster->names[i]);
+            fputc(',', file);
+            write_csv_string(file, roster->files[i]);
+            fprintf(file, ",%d,%.6f,%.6f,%.6f,%.6f,%.6f,%ld,%d,%d,%d\n", run->pid, run->started, run->ended,
+                    run->ended - run->started, run->user_cpu, run->system_cpu, run->max_rss_kb, exit_status,
+                    signal_no, run->timed_out);
+        }
+    }
+    if (json)
+    {
+        fprintf(file, "  ]\n}\n");
+    }
+    if (fclose(file) == EOF)
+    {
+        perror("Error writing report file");
+        return -1;
+    }
     return 0;
 }
+
+int run_processes(const Roster* roster, const SupervisionOptions* options)
+{
+    // parse the stats files once, the gladiators map the table instead of reading files
+    GladiatorTable table;
+    if (table_build(&table, roster->files, roster->count) == -1 || table_publish(&table) == -1)
+    {
+        return -1;
+    }
+
+    Supervisor supervisor = {0};
+    supervisor.roster = roster;
+    supervisor.options = options;
+    supervisor.runs = calloc(roster->count, sizeof(GladiatorRun));
+    supervisor.running = malloc(options->jobs * sizeof(int));
+    if (supervisor.runs == NULL || supervisor.running == NULL)
+    {
+        perror("malloc");
+        free(supervisor.runs);
+        free(supervisor.running);
+        table_destroy(&table);
+        return -1;
+    }
+    supervisor.epoch = monotonic_seconds();
+
+    int result = supervise_with_pidfd(&supervisor);
+    if (result == 1)
+    {
+        result = supervise_with_wait(&supervisor);
+    }
+    double wall_time = supervisor_now(&supervisor);
+
+    // the winner is the gladiator whose process stayed alive the longest (ties: terminated last).
+    // a gladiator killed by the timeout didn't finish its fight and can't win.
+    int winner_index = -1;
+    double winner_lifetime = -1;
+    for (int i = 0; i < supervisor.next; i++)
+    {
+        const GladiatorRun* run = &supervisor.runs[i];
+        if (run->timed_out)
+        {
+            fprintf(stderr, "%s timed out after %.3f s\n", roster->names[i], run->ended - run->started);
+            continue;
+        }
+        double lifetime = run->ended - run->started;
+        if (lifetime > winner_lifetime ||
+            (lifetime == winner_lifetime && run->ended >= supervisor.runs[winner_index].ended))
+        {
+            winner_lifetime = lifetime;
+            winner_index = i;
+        }
+    }
+
+    if (options->report_file != NULL && write_report(&supervisor, winner_index, wall_time) == -1)
+    {
+        result = -1;
+    }
+    free(supervisor.runs);
+    free(supervisor.running);
+    table_destroy(&table);
+
+    if (result == 0)
+    {
+        if (winner_index == -1)
+        {
+            fprintf(stderr, "Every gladiator timed out, there is no winner\n");
+            return -1;
+        }
+        printf("The gods have spoken, the winner of the tournament is %s!\n", roster->names[winner_index]);
+    }
+    return result;
+}
+
+// simulation mode
+// instead of racing processes, compute how many hits each gladiator survives.
+// a gladiator takes one hit per step, so the one who survives the most hits
+// is the last one standing. ties are broken by roster order (earlier falls first).
+
+// number of hits until health is not positive, -1 if the gladiator never falls.
+// damage is cyclic over the opponents, so instead of replaying every hit we find
+// for each position r in the cycle the first full-cycle count q with
+// q * cycle_damage + prefix[r] >= health, and take the earliest hit.
+long long hits_until_fall(long long health, const int* attacks, int num_attacks)
+{
+    if (health <= 0)
+    {
+        return 0;
+    }
+
+    long long cycle_damage = 0;
+    for (int r = 0; r < num_attacks; r++)
+    {
+        cycle_damage += attacks[r];
+    }
+
+    long long best = -1;
+    long long prefix = 0;
+    for (int r = 0; r < num_attacks; r++)
+    {
+        prefix += attacks[r];
+        long long cycles = 0;
+        if (prefix < health)
+        {
+            if (cycle_damage <= 0)
+            {
+                // later cycles never deal more damage than the first one
+                continue;
+            }
+            cycles = (health - prefix + cycle_damage - 1) / cycle_damage;
+        }
+        long long hits = cycles * num_attacks + r + 1;
+        if (best == -1 || hits < best)
+        {
+            best = hits;
+        }
+    }
+    return best;
+}
+
+// write the same log gladiator.c would, pid is the tournament's own pid
+int write_simulated_log(const char* glad_file, int health, const int* opponents, const int* attacks,
+                        int num_attacks, long long hits)
+{
+    int binary = log_binary_requested();
+    char filename[GLADIATOR_FILENAME_LEN];
+    get_log_filename(glad_file, binary, filename, sizeof(filename));
+    GladiatorLog fight_log;
+    if (log_open(&fight_log, filename, binary) == -1)
+    {
+        return -1;
+    }
+
+    log_started(&fight_log, getpid());
+    int i = 0;
+    for (long long hit = 0; hit < hits; hit++)
+    {
+        health -= attacks[i];
+        log_hit(&fight_log, opponents[i], attacks[i], health);
+        if (++i == num_attacks)
+        {
+            i = 0;
+        }
+    }
+    return log_close(&fight_log);
+}
+
+// hits survived by each gladiator, used to sort the elimination order
+long long* sort_hits;
+
+int compare_elimination(const void* a, const void* b)
+{
+    int i = *(const int*)a;
+    int j = *(const int*)b;
+    if (sort_hits[i] != sort_hits[j]) {
+        return sort_hits[i] < sort_hits[j] ? -1 : 1;
+    }
+    return i - j;
+}
+
+int simulate_tournament(const Roster* roster)
+{
+    GladiatorTable table;
+    int count = roster->count;
+    long long* hits = malloc(count * sizeof(long long));
+    int* order = malloc(count * sizeof(int));
+    int* attacks = NULL;
+    int result = -1;
+
+    if (hits == NULL || order == NULL)
+    {
+        perror("malloc");
+        free(hits);
+        free(order);
+        return -1;
+    }
+    if (table_build(&table, roster->files, count) == -1)
+    {
+        free(hits);
+        free(order);
+        return -1;
+    }
+    attacks = malloc((table.total_opponents + 1) * sizeof(int));
+    if (attacks == NULL)
+    {
+        perror("malloc");
+        goto out;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        int num_opponents = table_num_opponents(&table, i);
+        const int* opponents = table_opponents(&table, i);
+        for (int j = 0; j < num_opponents; j++)
+        {
+            attacks[j] = table_attack(&table, opponents[j]);
+        }
+        hits[i] = hits_until_fall(table.health[i], attacks, num_opponents);
+        if (hits[i] == -1)
+        {
+            fprintf(stderr, "%s can never fall, the tournament would not end\n", roster->names[i]);
+            goto out;
+        }
+        if (write_simulated_log(roster->files[i], table.health[i], opponents, attacks, num_opponents,
+                                hits[i]) == -1)
+        {
+            goto out;
+        }
+        order[i] = i;
+    }
+
+    sort_hits = hits;
+    qsort(order, count, sizeof(int), compare_elimination);
+
+    for (int i = 0; i < count - 1; i++)
+    {
+        printf("%s has fallen after %lld hits\n", roster->names[order[i]], hits[order[i]]);
+    }
+    printf("The gods have spoken, the winner of the tournament is %s!\n", roster->names[order[count - 1]]);
+    result = 0;
+
+out:
+    free(attacks);
+    free(hits);
+    free(order);
+    table_destroy(&table);
+    return result;
+}
+
+// Monte-Carlo mode
+// run many simulated tournaments with randomized variants on a thread pool and
+// report how often each gladiator wins. trials are handed out in batches and
+// every batch seeds its own RNG stream from (seed, batch number), so the result
+// does not depend on the number of threads. each thread counts wins locally and
+// adds them to the shared totals with atomic adds once it runs out of batches.
+
+typedef struct
+{
+    long long trials;
+    unsigned long long seed;
+    int shuffle_order;    // shuffle each gladiator's opponent order
+    int random_opponents; // replace every opponent by a random gladiator
+    double perturb;       // scale health and attack by 1 +- perturb
+} MonteCarloOptions;
+
+typedef struct
+{
+    const GladiatorTable* table;
+    const MonteCarloOptions* options;
+    long long num_batches;
+    long long next_batch;     // shared, taken with atomic fetch-add
+    unsigned long long* wins; // shared totals, updated with atomic adds
+} MonteCarloJob;
+
+// splitmix64, one independent stream per batch
+uint64_t rng_next(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// uniform in [0, bound)
+uint32_t rng_below(uint64_t* state, uint32_t bound)
+{
+    return (uint32_t)(((rng_next(state) >> 32) * bound) >> 32);
+}
+
+// uniform in [-1, 1)
+double rng_signed_unit(uint64_t* state)
+{
+    return (rng_next(state) >> 11) * 0x1.0p-52 - 1.0;
+}
+
+int perturb_value(int value, double perturb, uint64_t* state)
+{
+    if (perturb == 0)
+    {
+        return value;
+    }
+    return (int)(value * (1.0 + perturb * rng_signed_unit(state)) + 0.5);
+}
+
+// run one randomized tournament, returns the winner's index
+int monte_carlo_trial(const GladiatorTable* table, const MonteCarloOptions* options, uint64_t* rng,
+                      int* attack, int* attacks)
+{
+    int count = table->count;
+    for (int i = 0; i < count; i++)
+    {
+        attack[i] = perturb_value(table->attack[i], options->perturb, rng);
+    }
+
+    int winner = 0;
+    long long winner_hits = -1;
+    for (int i = 0; i < count; i++)
+    {
+        int num_opponents = table_num_opponents(table, i);
+        const int* opponents = table_opponents(table, i);
+        for (int j = 0; j < num_opponents; j++)
+        {
+            int opp_no = options->random_opponents ? (int)rng_below(rng, count) + 1 : opponents[j];
+            attacks[j] = opp_no >= 1 && opp_no <= count ? attack[opp_no - 1] : 0;
+        }
+        if (options->shuffle_order)
+        {
+            for (int j = num_opponents - 1; j > 0; j--)
+            {
+                int k = rng_below(rng, j + 1);
+                int tmp = attacks[j];
+                attacks[j] = attacks[k];
+                attacks[k] = tmp;
+            }
+        }
+        long long health = perturb_value(table->health[i], options->perturb, rng);
+        long long hits = hits_until_fall(health, attacks, num_opponents);
+        if (hits == -1)
+        {
+            hits = LLONG_MAX; // never falls in this variant
+        }
+        // ties go to the later gladiator, like in the elimination order
+        if (hits >= winner_hits)
+        {
+            winner_hits = hits;
+            winner = i;
+        }
+    }
+    return winner;
+}
+
+void* monte_carlo_worker(void* arg)
+{
+    MonteCarloJob* job = arg;
+    const GladiatorTable* table = job->table;
+    unsigned long long* local_wins = calloc(table->count, sizeof(unsigned long long));
+    int* attack = malloc(table->count * sizeof(int));
+    int* attacks = malloc((table->total_opponents + 1) * sizeof(int));
+    if (local_wins == NULL || attack == NULL || attacks == NULL)
+    {
+        perror("malloc");
+        free(local_wins);
+        free(attack);
+        free(attacks);
+        return (void*)-1;
+    }
+
+    long long batch;
+    while ((batch = __atomic_fetch_add(&job->next_batch, 1, __ATOMIC_RELAXED)) < job->num_batches)
+    {
+        uint64_t rng = job->options->seed ^ ((uint64_t)batch * 0xD1B54A32D192ED03ull);
+        long long first = batch * MONTE_CARLO_BATCH;
+        long long last = first + MONTE_CARLO_BATCH;
+        if (last > job->options->trials)
+        {
+            last = job->options->trials;
+        }
+        for (long long trial = first; trial < last; trial++)
+        {
+            local_wins[monte_carlo_trial(table, job->options, &rng, attack, attacks)]++;
+        }
+    }
+
+    for (int i = 0; i < table->count; i++)
+    {
+        if (local_wins[i] > 0)
+        {
+            __atomic_fetch_add(&job->wins[i], local_wins[i], __ATOMIC_RELAXED);
+        }
+    }
+    free(local_wins);
+    free(attack);
+    free(attacks);
+    return NULL;
+}
+
+// win counts used to sort the report
+unsigned long long* sort_wins;
+
+int compare_wins(const void* a, const void* b)
+{
+    int i = *(const int*)a;
+    int j = *(const int*)b;
+    if (sort_wins[i] != sort_wins[j]) {
+        return sort_wins[i] > sort_wins[j] ? -1 : 1;
+    }
+    return i - j;
+}
+
+int run_monte_carlo(const Roster* roster, const MonteCarloOptions* options, int threads)
+{
+    GladiatorTable table;
+    if (table_build(&table, roster->files, roster->count) == -1)
+    {
+        return -1;
+    }
+
+    MonteCarloJob job;
+    job.table = &table;
+    job.options = options;
+    job.num_batches = (options->trials + MONTE_CARLO_BATCH - 1) / MONTE_CARLO_BATCH;
+    job.next_batch = 0;
+    job.wins = calloc(roster->count, sizeof(unsigned long long));
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    int* order = malloc(roster->count * sizeof(int));
+    int result = -1;
+    if (job.wins == NULL || workers == NULL || order == NULL)
+    {
+        perror("malloc");
+        goto out;
+    }
+
+    double start = monotonic_seconds();
+    int started = 0;
+    for (; started < threads; started++)
+    {
+        int error = pthread_create(&workers[started], NULL, monte_carlo_worker, &job);
+        if (error != 0)
+        {
+            fprintf(stderr, "pthread_create: %s\n", strerror(error));
+            break;
+        }
+    }
+    result = started > 0 ? 0 : -1;
+    for (int i = 0; i < started; i++)
+    {
+        void* worker_result;
+        pthread_join(workers[i], &worker_result);
+        if (worker_result != NULL)
+        {
+            result = -1;
+        }
+    }
+    double elapsed = monotonic_seconds() - start;
+    if (result == -1)
+    {
+        goto out;
+    }
+
+    for (int i = 0; i < roster->count; i++)
+    {
+        order[i] = i;
+    }
+    sort_wins = job.wins;
+    qsort(order, roster->count, sizeof(int), compare_wins);
+
+    printf("Monte-Carlo: %lld tournaments on %d threads in %.3f s (%.0f tournaments/s)\n",
+           options->trials, started, elapsed, options->trials / (elapsed > 0 ? elapsed : 1e-9));
+    printf("%-20s %12s %9s\n", "Gladiator", "Wins", "Win rate");
+    for (int i = 0; i < roster->count; i++)
+    {
+        int index = order[i];
+        printf("%-20s %12llu %8.3f%%\n", roster->names[index], job.wins[index],
+               100.0 * job.wins[index] / options->trials);
+    }
+
+out:
+    free(job.wins);
+    free(workers);
+    free(order);
+    table_destroy(&table);
+    return result;
+}
+
+void print_usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s [--simulate | --monte-carlo <tournaments>] [--roster <roster_file>] [--jobs <n>] [--binary-logs]\n"
+                    "       process mode: [--timeout <seconds>] [--report <file.json|file.csv>]\n"
+                    "       Monte-Carlo variants: [--seed <n>] [--shuffle-order] [--random-opponents] [--perturb <fraction>]\n", program);
+}
+
+int main(int argc, char* argv[])
+{
+    int simulate = 0;
+    MonteCarloOptions monte_carlo = {0};
+    SupervisionOptions supervision = {0};
+    const char* roster_file = NULL;
+    long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--simulate") == 0)
+        {
+            simulate = 1;
+        }
+        else if (strcmp(argv[i], "--roster") == 0 && i + 1 < argc)
+        {
+            roster_file = argv[++i];
+        }
+        else if (strcmp(argv[i], "--binary-logs") == 0)
+        {
+            // the gladiators (and the simulation) pick the format up from the environment
+            setenv(GLADIATOR_LOG_FORMAT_ENV, "binary", 1);
+        }
+        else if (strcmp(argv[i], "--monte-carlo") == 0 && i + 1 < argc)
+        {
+            char* end;
+            monte_carlo.trials = strtoll(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || monte_carlo.trials <= 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            monte_carlo.seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "--shuffle-order") == 0)
+        {
+            monte_carlo.shuffle_order = 1;
+        }
+        else if (strcmp(argv[i], "--random-opponents") == 0)
+        {
+            monte_carlo.random_opponents = 1;
+        }
+        else if (strcmp(argv[i], "--perturb") == 0 && i + 1 < argc)
+        {
+            monte_carlo.perturb = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--timeout") == 0 && i + 1 < argc)
+        {
+            supervision.timeout = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--report") == 0 && i + 1 < argc)
+        {
+            supervision.report_file = argv[++i];
+        }
+        else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+        {
+            jobs = atoi(argv[++i]);
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (jobs < 1)
+    {
+        jobs = 1;
+    }
+
+    Roster roster;
+    if (roster_file == NULL)
+    {
+        default_roster(&roster);
+    }
+    else if (load_roster(roster_file, &roster) == -1)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (monte_carlo.trials > 0)
+    {
+        return run_monte_carlo(&roster, &monte_carlo, jobs) == 0 ? 0 : EXIT_FAILURE;
+    }
+    if (simulate)
+    {
+        return simulate_tournament(&roster) == 0 ? 0 : EXIT_FAILURE;
+    }
+    supervision.jobs = jobs;
+    return run_processes(&roster, &supervision) == 0 ? 0 : EXIT_FAILURE;
+}
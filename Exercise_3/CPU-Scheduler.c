@@ -8,46 +8,132 @@
 #include <signal.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sched.h>
+#include <stdint.h>
+#include <sys/timerfd.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stdarg.h>
 
 
-#define MAX_PROCESSES 1000
 #define MAX_NAME_LENGTH 50
 #define MAX_DESCRIPTION_LENGTH 100
+#define MLFQ_MAX_LEVELS 16
 
 // a flag to indicate if an alarm signal has been received
 volatile sig_atomic_t sig_alarm_received = 0;
 char output_buffer[4096]; // buffer for async-signal-safe output
 
-// comprator for sorting processes
-typedef int (*Compatator)(const void *, const void *);
-
+// simulation mode (--simulate): time only advances on the scheduler's virtual clock,
+// no children are forked and nothing sleeps. the timeline is the same as in real time.
+int simulate_mode = 0;
+// run the algorithms at the same time in worker processes (see run_algorithms_in_parallel)
+int parallel_mode = 0;
+
+// preemptive policies (--preemptive): SRTF, preemptive Priority and MLFQ run after the classic four.
+// mlfq_levels == 0 means the default levels: the time quantum, then twice and four times it.
+// a process waiting mlfq_aging time units in a lower level moves up one level (0: no aging).
+int preemptive_mode = 0;
+int mlfq_levels = 0;
+int mlfq_quanta[MLFQ_MAX_LEVELS];
+int mlfq_aging = 0;
+
+// multi-core Round Robin (--cores M): reported after the other algorithms
+#define PLACEMENT_GLOBAL 0   // one shared queue, any idle core takes the next process
+#define PLACEMENT_STEAL 1    // a queue per core, arrivals dealt out in turn, idle cores steal
+#define PLACEMENT_AFFINITY 2 // arrivals go to the least loaded core, steal only from a backlog
+int num_cores = 0;
+int placement_policy = PLACEMENT_STEAL;
+int pin_children = 0; // --pin: sched_setaffinity each real child to the core it runs on
+
+// length of one time unit of the trace and the quantum (--time-unit s/ms/us).
+// whole seconds wait for SIGALRM (alarm), shorter units sleep on a timerfd.
+long long time_unit_ns = 1000000000LL;
+int timer_fd = -1;
+pid_t timer_owner = -1; // a forked worker must not share its parent's timer
+
+// cpu-bound mode (--cpu-bound): children spin instead of pause() and every algorithm is followed
+// by how much CPU they actually got. a child's CPU time is read from its CPU clock around each
+// slice, context switches come from its rusage when it is reaped, and dispatch overhead is the
+// time spent in SIGCONT plus SIGSTOP until the child is seen stopped.
+int cpu_bound_mode = 0;
+
+// metrics export (--metrics file.json or file.csv): per-process times and percentiles of
+// every algorithm, written once all of them have run
+const char *metrics_path = NULL;
+int metrics_summary_only = 0; // --metrics-summary: leave out the per-process times
+
+// --algorithms fcfs,srtf,...: run only these (one bit per algorithm id), 0 runs the usual set
+unsigned algorithm_mask = 0;
 
 typedef struct
 {
-    pid_t pid; // process ID
-    int csvRowNumber;
-    char name[MAX_NAME_LENGTH];
-    char description[MAX_DESCRIPTION_LENGTH];
-
-    // time in seconds
-    int arrivalTime;
-    int burstTime;
-    int priority;
-    int startTime;      // time when the process starts running
-    int turnaroundTime; // time from arrival to completion
-    int waitingTime;    // time spent waiting in the ready queue
-    int completionTime; // time when the process completes execution
-    int remainingBurstTime; // remaining burst time for the process (used in Round Robin)
-} Process;
-
+    long long scheduled_ns;
+    long long achieved_ns;
+    long long dispatches;
+    long long dispatch_ns;
+    long voluntary_switches;
+    long involuntary_switches;
+} CpuAccounting;
+
+CpuAccounting accounting;
+
+// the process table: one array per field, indexed by the process' csv row.
+// the scheduling fields the algorithms touch on every step are kept apart from the
+// names and descriptions, which are only read when a line is printed.
 typedef struct
 {
-    Process processes[MAX_PROCESSES];
     int count;
+    int capacity;
+
+    // time in seconds
+    int *arrivalTime;
+    int *burstTime;
+    int *priority;
+    int *remainingBurstTime; // remaining burst time for the process (used in Round Robin)
+    int *startTime;          // time when the process starts running
+    int *completionTime;     // time when the process completes execution
+    int *waitingTime;        // time spent waiting in the ready queue
+    int *turnaroundTime;     // time from arrival to completion
+    pid_t *pid;              // process ID
+    long long *cpuAtContinue; // child's CPU time when its slice started (cpu-bound mode)
+
+    // names and descriptions, stored back to back in one buffer
+    size_t *name;        // offset of the name in text
+    size_t *description; // offset of the description in text
+    char *text;
+    size_t textUsed;
+    size_t textCapacity;
+
+    int *byArrival; // csv rows sorted by arrival time, then csv order
 } ProcessList;
 
+// comprator for ordering processes, a and b are csv rows
+typedef int (*Compatator)(const ProcessList *, int a, int b);
+
+const char *process_name(const ProcessList *processList, int i) {
+    return processList->text + processList->name[i];
+}
+
+const char *process_description(const ProcessList *processList, int i) {
+    return processList->text + processList->description[i];
+}
+
 // print functions
 
+// real time: write each line right away. simulation: let stdio batch the lines,
+// a large trace prints millions of them (flushed at the end of runCPUScheduler)
+void emit_output(const char *text, int len) {
+    if (simulate_mode) {
+        fwrite(text, 1, len, stdout);
+    } else {
+        write(STDOUT_FILENO, text, len);
+    }
+}
+
 void print_header(const char *scheduler_name) {
     int len = snprintf(output_buffer, sizeof(output_buffer),
                        "══════════════════════════════════════════════\n"
@@ -55,7 +141,7 @@ void print_header(const char *scheduler_name) {
                        ">> Engine Status  : Initialized\n"
                        "──────────────────────────────────────────────\n\n",
                        scheduler_name);
-    write(STDOUT_FILENO, output_buffer, len);
+    emit_output(output_buffer, len);
 }
 
 
@@ -65,7 +151,7 @@ void print_footer(double avg_waiting_time, int total_turnaround_time, const char
                    "\n──────────────────────────────────────────────\n"
                    ">> Engine Status  : Completed\n"
                    ">> Summary        :\n");
-    write(STDOUT_FILENO, output_buffer, len);
+    emit_output(output_buffer, len);
 
     // Print specific summary based on the scheduler type
     if (strcmp(scheduler_name, "Round Robin") == 0) {
@@ -75,7 +161,7 @@ void print_footer(double avg_waiting_time, int total_turnaround_time, const char
         len = snprintf(output_buffer, sizeof(output_buffer),
                        "   └─ Average Waiting Time : %.2f time units\n", avg_waiting_time);
     }
-    write(STDOUT_FILENO, output_buffer, len);
+    emit_output(output_buffer, len);
 
     len = snprintf(output_buffer, sizeof(output_buffer),
                    ">> End of Report\n"
@@ -84,44 +170,359 @@ void print_footer(double avg_waiting_time, int total_turnaround_time, const char
     if (strcmp(scheduler_name, "Round Robin") != 0) {
         len += snprintf(output_buffer + len, sizeof(output_buffer) - len, "\n");
     }
-    write(STDOUT_FILENO, output_buffer, len);
+    emit_output(output_buffer, len);
+}
+
+
+// summary of the preemptive policies: waiting, turnaround and response time.
+// more_lines: more summary lines follow (the multi-core report)
+void print_metrics_summary(const ProcessList *processList, int more_lines) {
+    double total_waiting = 0, total_turnaround = 0, total_response = 0;
+    for (int i = 0; i < processList->count; i++) {
+        total_waiting += processList->waitingTime[i];
+        total_turnaround += processList->turnaroundTime[i];
+        total_response += processList->startTime[i] - processList->arrivalTime[i];
+    }
+    int count = processList->count;
+    int len = snprintf(output_buffer, sizeof(output_buffer),
+                       "\n──────────────────────────────────────────────\n"
+                       ">> Engine Status  : Completed\n"
+                       ">> Summary        :\n"
+                       "   ├─ Average Waiting Time    : %.2f time units\n"
+                       "   ├─ Average Turnaround Time : %.2f time units\n"
+                       "   %s─ Average Response Time   : %.2f time units\n",
+                       total_waiting / count, total_turnaround / count,
+                       more_lines ? "├" : "└", total_response / count);
+    emit_output(output_buffer, len);
+}
+
+void print_report_end() {
+    int len = snprintf(output_buffer, sizeof(output_buffer),
+                       ">> End of Report\n"
+                       "══════════════════════════════════════════════\n\n");
+    emit_output(output_buffer, len);
+}
+
+void print_metrics_footer(const ProcessList *processList) {
+    print_metrics_summary(processList, 0);
+    print_report_end();
+}
+
+// process table storage
+
+void *grow_array(void *array, size_t count, size_t element_size) {
+    void *grown = realloc(array, count * element_size);
+    if (!grown) {
+        perror("realloc failed");
+        exit(EXIT_FAILURE);
+    }
+    return grown;
+}
+
+void grow_process_list(ProcessList *processList) {
+    int capacity = processList->capacity ? processList->capacity * 2 : 64;
+    processList->arrivalTime = grow_array(processList->arrivalTime, capacity, sizeof(int));
+    processList->burstTime = grow_array(processList->burstTime, capacity, sizeof(int));
+    processList->priority = grow_array(processList->priority, capacity, sizeof(int));
+    processList->remainingBurstTime = grow_array(processList->remainingBurstTime, capacity, sizeof(int));
+    processList->startTime = grow_array(processList->startTime, capacity, sizeof(int));
+    processList->completionTime = grow_array(processList->completionTime, capacity, sizeof(int));
+    processList->waitingTime = grow_array(processList->waitingTime, capacity, sizeof(int));
+    processList->turnaroundTime = grow_array(processList->turnaroundTime, capacity, sizeof(int));
+    processList->pid = grow_array(processList->pid, capacity, sizeof(pid_t));
+    processList->cpuAtContinue = grow_array(processList->cpuAtContinue, capacity, sizeof(long long));
+    processList->name = grow_array(processList->name, capacity, sizeof(size_t));
+    processList->description = grow_array(processList->description, capacity, sizeof(size_t));
+    processList->capacity = capacity;
+}
+
+// copy len bytes of str into the text buffer as a string, returns its offset
+size_t add_text(ProcessList *processList, const char *str, size_t str_len) {
+    size_t len = str_len + 1;
+    if (processList->textUsed + len > processList->textCapacity) {
+        size_t capacity = processList->textCapacity ? processList->textCapacity * 2 : 4096;
+        while (processList->textUsed + len > capacity) {
+            capacity *= 2;
+        }
+        processList->text = grow_array(processList->text, capacity, 1);
+        processList->textCapacity = capacity;
+    }
+    size_t offset = processList->textUsed;
+    memcpy(processList->text + offset, str, str_len);
+    processList->text[offset + str_len] = '\0';
+    processList->textUsed += len;
+    return offset;
+}
+
+void free_process_list(ProcessList *processList) {
+    free(processList->arrivalTime);
+    free(processList->burstTime);
+    free(processList->priority);
+    free(processList->remainingBurstTime);
+    free(processList->startTime);
+    free(processList->completionTime);
+    free(processList->waitingTime);
+    free(processList->turnaroundTime);
+    free(processList->pid);
+    free(processList->cpuAtContinue);
+    free(processList->name);
+    free(processList->description);
+    free(processList->text);
+    free(processList->byArrival);
+    memset(processList, 0, sizeof(*processList));
+}
+
+typedef struct
+{
+    int arrivalTime;
+    int row;
+} ArrivalKey;
+
+int compareArrivalKey(const void *a, const void *b) {
+    const ArrivalKey *k1 = (const ArrivalKey *)a;
+    const ArrivalKey *k2 = (const ArrivalKey *)b;
+    if (k1->arrivalTime != k2->arrivalTime) {
+        return k1->arrivalTime < k2->arrivalTime ? -1 : 1;
+    }
+    return k1->row - k2->row;
+}
+
+// the arrival order is the same for every algorithm, compute it once
+void sort_by_arrival(ProcessList *processList) {
+    int count = processList->count;
+    processList->byArrival = malloc((count > 0 ? count : 1) * sizeof(int));
+    if (!processList->byArrival) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    // traces are usually recorded in arrival order already
+    int sorted = 1;
+    for (int i = 0; i < count; i++) {
+        processList->byArrival[i] = i;
+        if (i > 0 && processList->arrivalTime[i] < processList->arrivalTime[i - 1]) {
+            sorted = 0;
+        }
+    }
+    if (sorted) {
+        return;
+    }
+
+    ArrivalKey *keys = malloc((count > 0 ? count : 1) * sizeof(ArrivalKey));
+    if (!keys) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < count; i++) {
+        keys[i].arrivalTime = processList->arrivalTime[i];
+        keys[i].row = i;
+    }
+    qsort(keys, count, sizeof(ArrivalKey), compareArrivalKey);
+    for (int i = 0; i < count; i++) {
+        processList->byArrival[i] = keys[i].row;
+    }
+    free(keys);
+}
+
+// CSV ingestion: a regular file is mapped and parsed in place. anything else (a pipe, or a
+// .gz trace streamed through gzip -dc) is read in chunks, carrying a partial last line over
+// to the next chunk. fields are split by hand, so lines can be of any length; names and
+// descriptions longer than the limits are cut.
+
+#define CSV_CHUNK_SIZE (1 << 20)
+
+// "%d": optional spaces and sign, then at least one digit. returns the position after the
+// number, or NULL if there is none
+const char *parse_int_field(const char *cursor, const char *end, int *value) {
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t')) {
+        cursor++;
+    }
+    int negative = 0;
+    if (cursor < end && (*cursor == '-' || *cursor == '+')) {
+        negative = *cursor == '-';
+        cursor++;
+    }
+    if (cursor == end || *cursor < '0' || *cursor > '9') {
+        return NULL;
+    }
+    long long number = 0;
+    while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+        number = number * 10 + (*cursor - '0');
+        cursor++;
+    }
+    *value = negative ? -number : number;
+    return cursor;
 }
 
+// one row: name,description,arrival,burst,priority. rows starting with '#' and rows that
+// aren't processes (e.g. an empty last line) are skipped
+void parse_csv_line(ProcessList *processList, const char *line, const char *end) {
+    if (line == end || line[0] == '#')
+        return;
+
+    const char *name = line;
+    const char *comma = memchr(name, ',', end - name);
+    if (!comma || comma == name)
+        return;
+    size_t name_len = comma - name;
+    const char *description = comma + 1;
+    comma = memchr(description, ',', end - description);
+    if (!comma || comma == description)
+        return;
+    size_t description_len = comma - description;
+
+    int arrivalTime, burstTime, priority;
+    const char *cursor = parse_int_field(comma + 1, end, &arrivalTime);
+    if (!cursor || cursor == end || *cursor != ',')
+        return;
+    cursor = parse_int_field(cursor + 1, end, &burstTime);
+    if (!cursor || cursor == end || *cursor != ',')
+        return;
+    if (!parse_int_field(cursor + 1, end, &priority))
+        return;
+
+    if (name_len > MAX_NAME_LENGTH)
+        name_len = MAX_NAME_LENGTH;
+    if (description_len > MAX_DESCRIPTION_LENGTH)
+        description_len = MAX_DESCRIPTION_LENGTH;
+
+    if (processList->count == processList->capacity)
+        grow_process_list(processList);
+    int i = processList->count;
+    processList->arrivalTime[i] = arrivalTime;
+    processList->burstTime[i] = burstTime;
+    processList->priority[i] = priority;
+    processList->name[i] = add_text(processList, name, name_len);
+    processList->description[i] = add_text(processList, description, description_len);
+    // initialize other fields to default values
+    processList->pid[i] = -1;
+    processList->turnaroundTime[i] = 0;
+    processList->waitingTime[i] = 0;
+    processList->completionTime[i] = -1;
+    processList->startTime[i] = -1;
+    processList->remainingBurstTime[i] = burstTime;
+    processList->count++;
+}
+
+// parse every complete line in data, returns how many bytes were used.
+// at_end: there is no more input, so a last line without '\n' is complete too
+size_t parse_csv_buffer(ProcessList *processList, const char *data, size_t len, int at_end) {
+    const char *cursor = data;
+    const char *end = data + len;
+    while (cursor < end) {
+        const char *newline = memchr(cursor, '\n', end - cursor);
+        if (!newline && !at_end)
+            break;
+        const char *line_end = newline ? newline : end;
+        // like fgets + sscanf, a '\r' before the newline is left at the end of the row
+        parse_csv_line(processList, cursor, line_end);
+        cursor = newline ? newline + 1 : end;
+    }
+    return cursor - data;
+}
+
+void read_csv_stream(int fd, ProcessList *processList) {
+    size_t capacity = CSV_CHUNK_SIZE;
+    char *buffer = malloc(capacity);
+    if (!buffer) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    size_t used = 0;
+    while (1) {
+        // a line longer than the buffer: make room for it
+        if (used == capacity) {
+            capacity *= 2;
+            buffer = grow_array(buffer, capacity, 1);
+        }
+        ssize_t len = read(fd, buffer + used, capacity - used);
+        if (len == -1) {
+            if (errno == EINTR)
+                continue;
+            perror("Failed to read file");
+            exit(EXIT_FAILURE);
+        }
+        used += len;
+        size_t parsed = parse_csv_buffer(processList, buffer, used, len == 0);
+        memmove(buffer, buffer + parsed, used - parsed);
+        used -= parsed;
+        if (len == 0)
+            break;
+    }
+    free(buffer);
+}
+
+// start gzip -dc on the trace, returns the read end of its output
+int open_gzip_stream(const char *filePath, pid_t *gzip_pid) {
+    int fds[2];
+    if (pipe(fds) == -1) {
+        perror("pipe failed");
+        exit(EXIT_FAILURE);
+    }
+    *gzip_pid = fork();
+    if (*gzip_pid < 0) {
+        perror("Fork failed");
+        exit(EXIT_FAILURE);
+    }
+    if (*gzip_pid == 0) {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execlp("gzip", "gzip", "-dc", "--", filePath, (char *)NULL);
+        perror("Failed to run gzip");
+        _exit(127);
+    }
+    close(fds[1]);
+    return fds[0];
+}
+
+int has_suffix(const char *str, const char *suffix) {
+    size_t len = strlen(str), suffix_len = strlen(suffix);
+    return len >= suffix_len && strcmp(str + len - suffix_len, suffix) == 0;
+}
 
 // read processes from CSV file
 void readProcessesFromCsv(const char *filePath, ProcessList *processList)
 {
-    FILE *file = fopen(filePath, "r");
-    if (!file)
+    if (has_suffix(filePath, ".gz"))
+    {
+        pid_t gzip_pid;
+        int fd = open_gzip_stream(filePath, &gzip_pid);
+        read_csv_stream(fd, processList);
+        close(fd);
+        int status;
+        if (waitpid(gzip_pid, &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            fprintf(stderr, "Failed to decompress %s\n", filePath);
+            exit(EXIT_FAILURE);
+        }
+        sort_by_arrival(processList);
+        return;
+    }
+
+    int fd = open(filePath, O_RDONLY);
+    if (fd == -1)
     {
         perror("Failed to open file");
         exit(EXIT_FAILURE);
     }
-    char line[256];
-    while (fgets(line, sizeof(line), file))
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    if (data != MAP_FAILED)
+    {
+        madvise(data, st.st_size, MADV_SEQUENTIAL);
+        parse_csv_buffer(processList, data, st.st_size, 1);
+        munmap(data, st.st_size);
+    }
+    else
     {
-        // skip row that starts with '#'
-        if (line[0] == '#')
-            continue;
-        Process process;
-        sscanf(line, "%50[^,],%100[^,],%d,%d,%d",
-               process.name,
-               process.description,
-               &process.arrivalTime,
-               &process.burstTime,
-               &process.priority);
-        // initialize other fields to default values
-        process.csvRowNumber = processList->count;
-        process.pid = -1;
-        process.turnaroundTime = 0;
-        process.waitingTime = 0;
-        process.completionTime = -1;
-        process.startTime = -1;
-        process.remainingBurstTime = process.burstTime;
-        processList->processes[processList->count] = process;
-        processList->count++;
-    }
-    fclose(file);
+        read_csv_stream(fd, processList);
+    }
+    close(fd);
+    sort_by_arrival(processList);
 }
 
 // alarm setup
@@ -176,6 +577,9 @@ void unblock_alarm()
 
 void forkProcesses(ProcessList *processList)
 {
+    if (simulate_mode)
+        return; // nothing to run, pids stay -1
+
     for (int i = 0; i < processList->count; i++)
     {
         pid_t pid = fork();
@@ -190,6 +594,15 @@ void forkProcesses(ProcessList *processList)
             signal(SIGALRM, SIG_IGN); // avoid interfering with parent's alarm
             signal(SIGCHLD, SIG_IGN); // the parent will handle reaping the child processes
 
+            if (cpu_bound_mode)
+            {
+                // burn CPU whenever we are allowed to run
+                volatile unsigned long work = 0;
+                while (1)
+                {
+                    work = work * 1103515245UL + 12345UL;
+                }
+            }
             while (1)
             {
                 pause(); // wait for signals from parent
@@ -199,7 +612,7 @@ void forkProcesses(ProcessList *processList)
         else
         {
             // parent process
-            processList->processes[i].pid = pid; // store the child's pid
+            processList->pid[i] = pid; // store the child's pid
 
             // stop the child process immediately after forking
             // so we can control when it starts and stops running
@@ -214,10 +627,49 @@ void forkProcesses(ProcessList *processList)
 }
 
 
+// wait on a timerfd: no signal masks, and the duration can be a few microseconds
+void pass_time_timerfd(int duration)
+{
+    if (timer_fd == -1 || timer_owner != getpid()) {
+        if (timer_fd != -1)
+            close(timer_fd);
+        timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+        if (timer_fd == -1) {
+            perror("timerfd_create failed");
+            exit(EXIT_FAILURE);
+        }
+        timer_owner = getpid();
+    }
+
+    long long ns = duration * time_unit_ns;
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = ns / 1000000000LL;
+    spec.it_value.tv_nsec = ns % 1000000000LL;
+    if (timerfd_settime(timer_fd, 0, &spec, NULL) == -1) {
+        perror("timerfd_settime failed");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t expirations;
+    while (read(timer_fd, &expirations, sizeof(expirations)) == -1) {
+        if (errno != EINTR) {
+            perror("read timerfd failed");
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
 void pass_time(int duration)
 {
-    if (duration <= 0)
+    // in simulation mode the callers advance the virtual clock by duration themselves
+    if (duration <= 0 || simulate_mode)
         return;
+
+    if (time_unit_ns != 1000000000LL) {
+        pass_time_timerfd(duration);
+        return;
+    }
     
     block_alarm();
     // reset alarm flag
@@ -249,88 +701,165 @@ void handle_idle_time(int targetTime, int *currentTime)
         // log idle time, using signal-safe function
         int len = snprintf(output_buffer, sizeof(output_buffer),
         "%d → %d: Idle.\n", *currentTime, *currentTime + idleDuration);
-        write(STDOUT_FILENO, output_buffer, len);
+        emit_output(output_buffer, len);
         *currentTime += idleDuration;
     }
 }
 
-void execute_procces_in_timeframe(Process *p, int duration, int* current_time) {
-    if (p->startTime == -1) {
-        p->startTime = *current_time; // record start time if not set
+// cpu-bound accounting
+
+long long monotonic_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// CPU time the child has used so far, read from its CPU clock
+long long child_cpu_ns(pid_t pid) {
+    clockid_t clock;
+    struct timespec ts;
+    if (clock_getcpuclockid(pid, &clock) != 0 || clock_gettime(clock, &ts) == -1) {
+        return 0;
     }
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
 
-    // continue the child process
-    if (kill(p->pid, SIGCONT) == -1) {
+void continue_child(ProcessList *processList, int i) {
+    pid_t pid = processList->pid[i];
+    long long started = cpu_bound_mode ? monotonic_ns() : 0;
+    if (cpu_bound_mode) {
+        processList->cpuAtContinue[i] = child_cpu_ns(pid);
+    }
+    if (kill(pid, SIGCONT) == -1) {
         perror("Failed to continue child process");
         exit(EXIT_FAILURE);
     }
+    if (cpu_bound_mode) {
+        accounting.dispatches++;
+        accounting.dispatch_ns += monotonic_ns() - started;
+    }
+}
+
+// stop the child after a slice of duration time units
+void stop_child(ProcessList *processList, int i, int duration) {
+    pid_t pid = processList->pid[i];
+    long long started = cpu_bound_mode ? monotonic_ns() : 0;
+    if (kill(pid, SIGSTOP) == -1) {
+        perror("Failed to stop child process after execution");
+        exit(EXIT_FAILURE);
+    }
+    if (cpu_bound_mode) {
+        // SIGSTOP is asynchronous, the child may still be running until we see it stopped
+        if (waitpid(pid, NULL, WUNTRACED) == -1) {
+            perror("waitpid failed");
+            exit(EXIT_FAILURE);
+        }
+        accounting.dispatch_ns += monotonic_ns() - started;
+        accounting.scheduled_ns += duration * time_unit_ns;
+        accounting.achieved_ns += child_cpu_ns(pid) - processList->cpuAtContinue[i];
+    }
+}
+
+// wait for a killed child, keeping its context switch counts
+void reap_child(pid_t pid) {
+    struct rusage usage;
+    if (wait4(pid, NULL, 0, &usage) > 0 && cpu_bound_mode) {
+        accounting.voluntary_switches += usage.ru_nvcsw;
+        accounting.involuntary_switches += usage.ru_nivcsw;
+    }
+}
+
+void print_accounting(const char *scheduler_name) {
+    double achieved_share = accounting.scheduled_ns > 0 ? 100.0 * accounting.achieved_ns / accounting.scheduled_ns : 0;
+    double dispatch_us = accounting.dispatches > 0 ? accounting.dispatch_ns / 1000.0 / accounting.dispatches : 0;
+    int len = snprintf(output_buffer, sizeof(output_buffer),
+                       ">> CPU Accounting : %s\n"
+                       "   ├─ Scheduled CPU Time : %.6f s\n"
+                       "   ├─ Achieved CPU Time  : %.6f s (%.2f%%)\n"
+                       "   ├─ Context Switches   : %ld voluntary, %ld involuntary\n"
+                       "   └─ Dispatch Overhead  : %lld dispatches, %.1f us each (SIGCONT + SIGSTOP)\n"
+                       "══════════════════════════════════════════════\n\n",
+                       scheduler_name, accounting.scheduled_ns / 1e9, accounting.achieved_ns / 1e9,
+                       achieved_share, accounting.voluntary_switches, accounting.involuntary_switches,
+                       accounting.dispatches, dispatch_us);
+    emit_output(output_buffer, len);
+}
+
+void execute_procces_in_timeframe(ProcessList *processList, int i, int duration, int* current_time) {
+    if (processList->startTime[i] == -1) {
+        processList->startTime[i] = *current_time; // record start time if not set
+    }
+
+    // continue the child process
+    if (!simulate_mode)
+        continue_child(processList, i);
 
     // pass time until alarm
     pass_time(duration);
 
     // stop the child process after execution
-    if (kill(p->pid, SIGSTOP) == -1) {
-        perror("Failed to stop child process after execution");
-        exit(EXIT_FAILURE);
-    }
+    if (!simulate_mode)
+        stop_child(processList, i, duration);
 
     // log process execution
     int len = snprintf(output_buffer, sizeof(output_buffer),
                        "%d → %d: %s Running %s.\n",
                        *current_time, *current_time + duration,
-                       p->name, p->description);
-    write(STDOUT_FILENO, output_buffer, len);
+                       process_name(processList, i), process_description(processList, i));
+    emit_output(output_buffer, len);
 
     *current_time += duration;
 
 
-    p->remainingBurstTime -= duration; // update remaining burst time
+    processList->remainingBurstTime[i] -= duration; // update remaining burst time
 
 }
 
-void finalize_process(Process *p, int *num_completed, int *current_time) {
+void finalize_process(ProcessList *processList, int i, int *num_completed, int *current_time) {
     
-    p->completionTime = *current_time;
-    p->turnaroundTime = p->completionTime - p->arrivalTime;
-    p->waitingTime = p->turnaroundTime - p->burstTime;
+    processList->completionTime[i] = *current_time;
+    processList->turnaroundTime[i] = processList->completionTime[i] - processList->arrivalTime[i];
+    processList->waitingTime[i] = processList->turnaroundTime[i] - processList->burstTime[i];
+
+    // kill child (there is none in simulation mode)
+    pid_t pid = processList->pid[i];
+    if (pid > 0) {
+        if (kill(pid, SIGKILL) == -1 && errno != ESRCH) {
+            perror("Failed to kill child process");
+            exit(EXIT_FAILURE);
+        }
 
-    // kill child
-    if (kill(p->pid, SIGKILL) == -1 && errno != ESRCH) {
-        perror("Failed to kill child process");
-        exit(EXIT_FAILURE);
+        reap_child(pid); // wait for the child process to terminate
+        processList->pid[i] = -1;
     }
 
-    waitpid(p->pid, NULL, 0); // wait for the child process to terminate
-    p->pid = -1;
-
     (*num_completed)++; // increment the number of completed processes
 }
 
 void cleanup_children(ProcessList *processList) {
     for (int i = 0; i < processList->count; i++) {
-        Process *p = &processList->processes[i];
-        if (p->pid > 0) {
+        pid_t pid = processList->pid[i];
+        if (pid > 0) {
             // kill the child process if it is still running
-            kill(p->pid, SIGSTOP); // stop the process if it is running
-            if (kill(p->pid, SIGKILL) == -1 && errno != ESRCH) {
+            kill(pid, SIGSTOP); // stop the process if it is running
+            if (kill(pid, SIGKILL) == -1 && errno != ESRCH) {
                 perror("Failed to kill child process during cleanup");
                 exit(EXIT_FAILURE);
             }
-            waitpid(p->pid, NULL, 0); // wait for the child process to terminate
-            p->pid = -1; // reset pid to indicate it has been cleaned up
+            reap_child(pid); // wait for the child process to terminate
+            processList->pid[i] = -1; // reset pid to indicate it has been cleaned up
         }
     }
 }
 
 void reset_attributes(ProcessList *processList) {
     for (int i = 0; i < processList->count; i++) {
-        Process *p = &processList->processes[i];
-        p->pid = -1;
-        p->remainingBurstTime = p->burstTime;
-        p->startTime = -1;
-        p->completionTime = -1;
-        p->waitingTime = 0;
-        p->turnaroundTime = 0;
+        processList->pid[i] = -1;
+        processList->remainingBurstTime[i] = processList->burstTime[i];
+        processList->startTime[i] = -1;
+        processList->completionTime[i] = -1;
+        processList->waitingTime[i] = 0;
+        processList->turnaroundTime[i] = 0;
     }
 }
 
@@ -347,178 +876,242 @@ void cleanup_process_list(ProcessList *processList) {
 
 // scheduler helper functions
 
-int compareFCFS(const void *a, const void *b)
+int compareFCFS(const ProcessList *processList, int a, int b)
 {
-    const Process *p1 = (const Process *)a;
-    const Process *p2 = (const Process *)b;
-    if (p1->arrivalTime != p2->arrivalTime) {
-        return p1->arrivalTime - p2->arrivalTime;
+    const int *arrival = processList->arrivalTime;
+    if (arrival[a] != arrival[b]) {
+        return arrival[a] - arrival[b];
     }
     // maintain original order
-    return p1->csvRowNumber - p2->csvRowNumber;
+    return a - b;
 }
 
-int compareSJF(const void *a, const void *b)
+int compareSJF(const ProcessList *processList, int a, int b)
 {
-    Process *p1 = (Process *)a;
-    Process *p2 = (Process *)b;
+    const int *burst = processList->burstTime;
+    const int *arrival = processList->arrivalTime;
 
-    if (p1->burstTime != p2->burstTime) {
-        return p1->burstTime - p2->burstTime; // shorter burst time first
+    if (burst[a] != burst[b]) {
+        return burst[a] - burst[b]; // shorter burst time first
     }
-    if (p1->arrivalTime != p2->arrivalTime) {
-        return p1->arrivalTime - p2->arrivalTime; // earlier arrival time first
+    if (arrival[a] != arrival[b]) {
+        return arrival[a] - arrival[b]; // earlier arrival time first
     }
-    return p1->csvRowNumber - p2->csvRowNumber; // maintain original order
+    return a - b; // maintain original order
 }
 
-int compareProcessesByPriority(const void *a, const void *b)
+int compareProcessesByPriority(const ProcessList *processList, int a, int b)
 {
-    const Process *p1 = (const Process *)a;
-    const Process *p2 = (const Process *)b;
+    const int *priority = processList->priority;
+    const int *arrival = processList->arrivalTime;
 
-    if (p1->priority != p2->priority) {
-        return p1->priority - p2->priority; // lower priority value first
+    if (priority[a] != priority[b]) {
+        return priority[a] - priority[b]; // lower priority value first
     }
-    if (p1->arrivalTime != p2->arrivalTime) {
-        return p1->arrivalTime - p2->arrivalTime; // earlier arrival time first
+    if (arrival[a] != arrival[b]) {
+        return arrival[a] - arrival[b]; // earlier arrival time first
     }
-    return p1->csvRowNumber - p2->csvRowNumber; // maintain original order
+    return a - b; // maintain original order
 }
 
-int get_next_arrival(const ProcessList *processList, int currentTime) {
-    int next_arrival = -1;
-    for (int i = 0; i < processList->count; i++) {
-        const Process *p = &processList->processes[i];
-        if (p->completionTime == -1 && (next_arrival == -1 || p->arrivalTime < next_arrival)) {
-            next_arrival = p->arrivalTime;
+// preemptive: the process with the least work left goes first
+int compareSRTF(const ProcessList *processList, int a, int b)
+{
+    const int *remaining = processList->remainingBurstTime;
+    const int *arrival = processList->arrivalTime;
+
+    if (remaining[a] != remaining[b]) {
+        return remaining[a] - remaining[b]; // less remaining time first
+    }
+    if (arrival[a] != arrival[b]) {
+        return arrival[a] - arrival[b]; // earlier arrival time first
+    }
+    return a - b; // maintain original order
+}
+
+int compareInt(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+// ready queue: a binary min-heap of csv rows ordered by a scheduler comparator,
+// so picking the next process is O(log n) instead of a scan over the whole list
+
+typedef struct
+{
+    int *heap;
+    int count;
+    const ProcessList *processList;
+    Compatator comparator;
+} ReadyQueue;
+
+void ready_queue_init(ReadyQueue *queue, const ProcessList *processList, Compatator comparator) {
+    queue->heap = malloc((processList->count > 0 ? processList->count : 1) * sizeof(int));
+    if (!queue->heap) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    queue->count = 0;
+    queue->processList = processList;
+    queue->comparator = comparator;
+}
+
+void ready_queue_free(ReadyQueue *queue) {
+    free(queue->heap);
+    queue->heap = NULL;
+    queue->count = 0;
+}
+
+void ready_queue_push(ReadyQueue *queue, int p) {
+    int i = queue->count++;
+    // sift up
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (queue->comparator(queue->processList, queue->heap[parent], p) <= 0) {
+            break;
         }
+        queue->heap[i] = queue->heap[parent];
+        i = parent;
     }
-    return next_arrival; // no more arrivals
+    queue->heap[i] = p;
+}
+
+// the first process in the queue's order, -1 if the queue is empty
+int ready_queue_pop(ReadyQueue *queue) {
+    if (queue->count == 0) {
+        return -1;
+    }
+    const ProcessList *processList = queue->processList;
+    int top = queue->heap[0];
+    int last = queue->heap[--queue->count];
+    // sift the last element down from the root
+    int i = 0;
+    while (1) {
+        int child = 2 * i + 1;
+        if (child >= queue->count) {
+            break;
+        }
+        if (child + 1 < queue->count &&
+            queue->comparator(processList, queue->heap[child + 1], queue->heap[child]) < 0) {
+            child++;
+        }
+        if (queue->comparator(processList, last, queue->heap[child]) <= 0) {
+            break;
+        }
+        queue->heap[i] = queue->heap[child];
+        i = child;
+    }
+    if (queue->count > 0) {
+        queue->heap[i] = last;
+    }
+    return top;
 }
 
 // scheduler algorithms
 
 void run_compare_based_scheduler(ProcessList *process_list, Compatator comparator, const char *scheduler_name) {
     print_header(scheduler_name);
-    // copy ProcessList to a local variable
-    ProcessList localProcessList;
-    localProcessList.count = process_list->count;
-    for (int i = 0; i < process_list->count; i++) {
-        localProcessList.processes[i] = process_list->processes[i];
-    }
+    int count = process_list->count;
 
-    // sort processes by arrival time
-    qsort(localProcessList.processes, localProcessList.count, sizeof(Process), comparator);
+    // processes are moved to the ready queue in arrival order as the clock reaches them
+    const int *by_arrival = process_list->byArrival;
+    int next_arrival = 0; // first process that hasn't arrived yet
+
+    // the ready queue picks the first arrived process in the scheduler's order
+    ReadyQueue ready;
+    ready_queue_init(&ready, process_list, comparator);
 
     int currentTime = 0;
     int completed_processes = 0;
 
-    while (completed_processes < localProcessList.count) {
-        
-        Process *next_process = NULL;
-        // find the next process to execute
-        for (int i = 0; i < localProcessList.count; i++) {
-            Process *p = &localProcessList.processes[i];
-            if (p->completionTime == -1 && p->arrivalTime <= currentTime) {
-                next_process = p;
-                break;
-            }
+    while (completed_processes < count) {
+        // admit every process that has arrived by now
+        while (next_arrival < count && process_list->arrivalTime[by_arrival[next_arrival]] <= currentTime) {
+            ready_queue_push(&ready, by_arrival[next_arrival]);
+            next_arrival++;
         }
 
-        if (next_process) {
-            // simulate idle time
-            handle_idle_time(next_process->arrivalTime, &currentTime);
+        int next_process = ready_queue_pop(&ready);
+
+        if (next_process != -1) {
             // calculate waiting time for this process
-            if (next_process->startTime == -1) {
-                next_process->startTime = currentTime;
+            if (process_list->startTime[next_process] == -1) {
+                process_list->startTime[next_process] = currentTime;
             }
-            next_process->waitingTime = next_process->startTime - next_process->arrivalTime;
+            process_list->waitingTime[next_process] =
+                process_list->startTime[next_process] - process_list->arrivalTime[next_process];
 
             // execute process for duration of its burst time
-            execute_procces_in_timeframe(next_process, next_process->burstTime, &currentTime);
+            execute_procces_in_timeframe(process_list, next_process, process_list->burstTime[next_process],
+                                         &currentTime);
 
             // finalize (set completion time, turnaround time, kill process, add to current time)
-            finalize_process(next_process, &completed_processes, &currentTime);
+            finalize_process(process_list, next_process, &completed_processes, &currentTime);
+        } else if (next_arrival < count) {
+            // nothing is ready, go idle until the next arrival
+            handle_idle_time(process_list->arrivalTime[by_arrival[next_arrival]], &currentTime);
         } else {
-            // find if there are any processes that have not yet arrived
-            int nextArrival = get_next_arrival(&localProcessList, currentTime);
-            // if there are, go idle
-            if (nextArrival != -1) {
-                handle_idle_time(nextArrival, &currentTime);
-            }
-            else
-            {
-                // else, all processes are completed, break the loop
-                break;
-            }
+            // all processes are completed, break the loop
+            break;
         }
     }
+    ready_queue_free(&ready);
+
     // calculate average waiting time
     double totalWaitingTime = 0;
-    for (int i = 0; i < localProcessList.count; i++) {
-        totalWaitingTime += localProcessList.processes[i].waitingTime;
+    for (int i = 0; i < count; i++) {
+        totalWaitingTime += process_list->waitingTime[i];
     }
-    double averageWaitingTime = totalWaitingTime / localProcessList.count;
+    double averageWaitingTime = totalWaitingTime / count;
     // print report footer
     print_footer(averageWaitingTime, 0, scheduler_name);
 }
 
-void run_scheduler_with_setup(ProcessList *process_list, Compatator comparator, const char *scheduler_name) {
-    forkProcesses(process_list); // fork processes
-    run_compare_based_scheduler(process_list, comparator, scheduler_name);
-    cleanup_process_list(process_list); // cleanup processes
-}
-
 // Round Robin
 
 void run_round_robin(ProcessList *process_list, int time_quantum) {
     print_header("Round Robin");
-
-    ProcessList localProcessList;
-    localProcessList.count = process_list->count;
-    for (int i = 0; i < process_list->count; i++) {
-        localProcessList.processes[i] = process_list->processes[i];
+    int count = process_list->count;
+
+    // processes in arrival order, next_arrival is the first one not admitted yet.
+    // our own copy: each batch of arrivals is re-sorted into csv order when admitted
+    int *by_arrival = malloc((count > 0 ? count : 1) * sizeof(int));
+    // circular queue, a process is queued at most once so count slots are enough
+    int *queue = malloc((count > 0 ? count : 1) * sizeof(int));
+    if (!by_arrival || !queue) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
     }
+    memcpy(by_arrival, process_list->byArrival, count * sizeof(int));
+    int next_arrival = 0;
+    int head = 0, queued = 0; // queue pointers
 
     int current_time = 0;
     int completed_count = 0;
 
-    // circular queue
-    Process *queue[MAX_PROCESSES];
-    int head = 0, tail = 0; // queue pointers
-
-    while (completed_count < localProcessList.count) {
-        for (int i = 0; i < localProcessList.count; i++) {
-            Process *p = &localProcessList.processes[i];
-            if (p->completionTime == -1 && p->arrivalTime <= current_time) {
-                // check if the process is already in the queue
-                int in_queue = 0;
-                for (int j = head; j != tail; j = (j + 1) % MAX_PROCESSES) {
-                    if (queue[j] == p) {
-                        in_queue = 1;
-                        break;
-                    }
-                }
-
-                // if not in queue, add it
-                if (!in_queue) {
-                    queue[tail] = p;
-                    tail = (tail + 1) % MAX_PROCESSES;
-                }
-            }
+    while (completed_count < count) {
+        // admit the processes that arrived since the last admission, in csv order,
+        // behind the process that was just put back
+        int first_admitted = next_arrival;
+        while (next_arrival < count && process_list->arrivalTime[by_arrival[next_arrival]] <= current_time) {
+            next_arrival++;
+        }
+        qsort(by_arrival + first_admitted, next_arrival - first_admitted, sizeof(int), compareInt);
+        for (int i = first_admitted; i < next_arrival; i++) {
+            queue[(head + queued) % count] = by_arrival[i];
+            queued++;
         }
 
-        Process *current_process = NULL;
-        if (head != tail) { // if the queue is not empty
+        int current_process = -1;
+        if (queued > 0) { // if the queue is not empty
             current_process = queue[head];
-            head = (head + 1) % MAX_PROCESSES;
+            head = (head + 1) % count;
+            queued--;
         }
         // if there are no processes in the queue, go idle
-        if (!current_process) {
-            int next_arrival = get_next_arrival(&localProcessList, current_time);
-            if (next_arrival != -1) {
-                handle_idle_time(next_arrival, &current_time);
+        if (current_process == -1) {
+            if (next_arrival < count) {
+                handle_idle_time(process_list->arrivalTime[by_arrival[next_arrival]], &current_time);
             } else {
                 // all processes are completed
                 break;
@@ -526,49 +1119,1046 @@ void run_round_robin(ProcessList *process_list, int time_quantum) {
         } else {
             // run the minimum between time quantum and remaining burst time
             int run_duration;
-            if (current_process->remainingBurstTime < time_quantum) {
-                run_duration = current_process->remainingBurstTime;
+            if (process_list->remainingBurstTime[current_process] < time_quantum) {
+                run_duration = process_list->remainingBurstTime[current_process];
             } else {
                 run_duration = time_quantum;
             }
 
-            execute_procces_in_timeframe(current_process, run_duration, &current_time);
+            execute_procces_in_timeframe(process_list, current_process, run_duration, &current_time);
 
-            if(current_process->remainingBurstTime <= 0) {
+            if(process_list->remainingBurstTime[current_process] <= 0) {
                 // process completed
-                finalize_process(current_process, &completed_count, &current_time);
+                finalize_process(process_list, current_process, &completed_count, &current_time);
             } else {
                 // process not completed, add it back to the end of the queue
-                queue[tail] = current_process;
-                tail = (tail + 1) % MAX_PROCESSES;
+                queue[(head + queued) % count] = current_process;
+                queued++;
             }
 
             
         }
     }
+    free(by_arrival);
+    free(queue);
     
     print_footer(0, current_time, "Round Robin");
 }
 
+// preemptive schedulers
+
+// like run_compare_based_scheduler, but an arriving process takes the CPU as soon as it comes
+// first in the comparator's order. the running process is only compared with new arrivals:
+// it already came first among the waiting ones and its key never grows while it runs.
+void run_preemptive_scheduler(ProcessList *process_list, Compatator comparator, const char *scheduler_name) {
+    print_header(scheduler_name);
+    int count = process_list->count;
+    const int *by_arrival = process_list->byArrival;
+    int next_arrival = 0;
+
+    ReadyQueue ready;
+    ready_queue_init(&ready, process_list, comparator);
+
+    int currentTime = 0;
+    int completed_processes = 0;
+
+    while (completed_processes < count) {
+        while (next_arrival < count && process_list->arrivalTime[by_arrival[next_arrival]] <= currentTime) {
+            ready_queue_push(&ready, by_arrival[next_arrival]);
+            next_arrival++;
+        }
+
+        int p = ready_queue_pop(&ready);
+        if (p == -1) {
+            if (next_arrival < count) {
+                handle_idle_time(process_list->arrivalTime[by_arrival[next_arrival]], &currentTime);
+                continue;
+            }
+            break;
+        }
+
+        // run until completion or until the first arrival that would come before p,
+        // with p's remaining time as it will be when that process arrives
+        int remaining = process_list->remainingBurstTime[p];
+        int duration = remaining;
+        for (int k = next_arrival; k < count; k++) {
+            int arrival = process_list->arrivalTime[by_arrival[k]];
+            if (arrival >= currentTime + duration) {
+                break;
+            }
+            process_list->remainingBurstTime[p] = remaining - (arrival - currentTime);
+            if (comparator(process_list, by_arrival[k], p) < 0) {
+                duration = arrival - currentTime;
+                break;
+            }
+        }
+        process_list->remainingBurstTime[p] = remaining;
+
+        execute_procces_in_timeframe(process_list, p, duration, &currentTime);
+        if (process_list->remainingBurstTime[p] <= 0) {
+            finalize_process(process_list, p, &completed_processes, &currentTime);
+        } else {
+            ready_queue_push(&ready, p); // preempted
+        }
+    }
+    ready_queue_free(&ready);
+    print_metrics_footer(process_list);
+}
+
+// MLFQ
+
+// the levels are FIFO queues linked through next[], new processes enter level 0.
+// a process that uses its whole quantum moves down a level; one that is preempted by an
+// arrival (only possible below level 0) goes back to the end of its level.
+typedef struct
+{
+    int head[MLFQ_MAX_LEVELS];
+    int tail[MLFQ_MAX_LEVELS];
+    int *next;       // next process in the same level, -1 at the end
+    int *level;
+    int *enqueuedAt; // when the process joined its level, for aging
+} FeedbackQueues;
+
+void mlfq_push(FeedbackQueues *queues, int p, int level, int now) {
+    queues->next[p] = -1;
+    queues->level[p] = level;
+    queues->enqueuedAt[p] = now;
+    if (queues->tail[level] == -1) {
+        queues->head[level] = p;
+    } else {
+        queues->next[queues->tail[level]] = p;
+    }
+    queues->tail[level] = p;
+}
+
+int mlfq_pop(FeedbackQueues *queues, int level) {
+    int p = queues->head[level];
+    if (p != -1) {
+        queues->head[level] = queues->next[p];
+        if (queues->head[level] == -1) {
+            queues->tail[level] = -1;
+        }
+    }
+    return p;
+}
+
+void run_mlfq(ProcessList *process_list, int levels, const int *quanta, int aging) {
+    print_header("MLFQ");
+    int count = process_list->count;
+    const int *by_arrival = process_list->byArrival;
+    int next_arrival = 0;
+
+    FeedbackQueues queues;
+    size_t size = (count > 0 ? count : 1) * sizeof(int);
+    queues.next = malloc(size);
+    queues.level = malloc(size);
+    queues.enqueuedAt = malloc(size);
+    if (!queues.next || !queues.level || !queues.enqueuedAt) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int l = 0; l < levels; l++) {
+        queues.head[l] = queues.tail[l] = -1;
+    }
+
+    int current_time = 0;
+    int completed_count = 0;
+
+    while (completed_count < count) {
+        while (next_arrival < count && process_list->arrivalTime[by_arrival[next_arrival]] <= current_time) {
+            mlfq_push(&queues, by_arrival[next_arrival], 0, current_time);
+            next_arrival++;
+        }
+        // aging: each level is in joining order, so only its head can be due
+        if (aging > 0) {
+            for (int l = 1; l < levels; l++) {
+                while (queues.head[l] != -1 && current_time - queues.enqueuedAt[queues.head[l]] >= aging) {
+                    mlfq_push(&queues, mlfq_pop(&queues, l), l - 1, current_time);
+                }
+            }
+        }
+
+        int level = 0;
+        while (level < levels && queues.head[level] == -1) {
+            level++;
+        }
+        if (level == levels) {
+            if (next_arrival < count) {
+                handle_idle_time(process_list->arrivalTime[by_arrival[next_arrival]], &current_time);
+                continue;
+            }
+            break;
+        }
+
+        int p = mlfq_pop(&queues, level);
+        int duration = process_list->remainingBurstTime[p];
+        if (duration > quanta[level]) {
+            duration = quanta[level];
+        }
+        // below the top level, an arrival preempts
+        int preempted = 0;
+        if (level > 0 && next_arrival < count) {
+            int arrival = process_list->arrivalTime[by_arrival[next_arrival]];
+            if (arrival < current_time + duration) {
+                duration = arrival - current_time;
+                preempted = 1;
+            }
+        }
+
+        execute_procces_in_timeframe(process_list, p, duration, &current_time);
+        if (process_list->remainingBurstTime[p] <= 0) {
+            finalize_process(process_list, p, &completed_count, &current_time);
+        } else if (preempted || level == levels - 1) {
+            mlfq_push(&queues, p, level, current_time);
+        } else {
+            mlfq_push(&queues, p, level + 1, current_time);
+        }
+    }
+    free(queues.next);
+    free(queues.level);
+    free(queues.enqueuedAt);
+    print_metrics_footer(process_list);
+}
+
+// parse "--mlfq-quanta 2,4,8", returns -1 if the list isn't valid
+int parse_mlfq_quanta(const char *list) {
+    int levels = 0;
+    const char *cursor = list;
+    while (*cursor) {
+        char *end;
+        long quantum = strtol(cursor, &end, 10);
+        if (end == cursor || quantum <= 0 || levels == MLFQ_MAX_LEVELS || (*end != ',' && *end != '\0')) {
+            return -1;
+        }
+        mlfq_quanta[levels++] = quantum;
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    if (levels == 0) {
+        return -1;
+    }
+    mlfq_levels = levels;
+    return 0;
+}
+
+// multi-core Round Robin
+
+// run queues linked through per-process next/prev, so a process can be taken from either end.
+// queue c belongs to core c; the global policy only uses queue 0.
+typedef struct
+{
+    int *head;
+    int *tail;
+    int *length;
+    int *next;
+    int *prev;
+} RunQueues;
+
+void run_queue_push(RunQueues *queues, int q, int p) {
+    queues->next[p] = -1;
+    queues->prev[p] = queues->tail[q];
+    if (queues->tail[q] == -1) {
+        queues->head[q] = p;
+    } else {
+        queues->next[queues->tail[q]] = p;
+    }
+    queues->tail[q] = p;
+    queues->length[q]++;
+}
+
+void run_queue_remove(RunQueues *queues, int q, int p) {
+    if (queues->prev[p] == -1) {
+        queues->head[q] = queues->next[p];
+    } else {
+        queues->next[queues->prev[p]] = queues->next[p];
+    }
+    if (queues->next[p] == -1) {
+        queues->tail[q] = queues->prev[p];
+    } else {
+        queues->prev[queues->next[p]] = queues->prev[p];
+    }
+    queues->length[q]--;
+}
+
+typedef struct
+{
+    int running;    // process on the core, -1 if idle
+    int sliceStart;
+    int sliceEnd;
+    long busyTime;
+    int migrations; // processes that ran somewhere else before coming to this core
+    int steals;
+} Core;
+
+const char *placement_name(int placement) {
+    switch (placement) {
+    case PLACEMENT_GLOBAL:
+        return "global queue";
+    case PLACEMENT_AFFINITY:
+        return "affinity";
+    default:
+        return "work stealing";
+    }
+}
+
+// queue a new arrival according to the placement policy
+int place_arrival(const RunQueues *queues, const Core *cores, int num, int placement, int arrivals) {
+    if (placement == PLACEMENT_GLOBAL) {
+        return 0;
+    }
+    if (placement == PLACEMENT_STEAL) {
+        return arrivals % num;
+    }
+    int best = 0;
+    for (int c = 1; c < num; c++) {
+        int load = queues->length[c] + (cores[c].running != -1);
+        if (load < queues->length[best] + (cores[best].running != -1)) {
+            best = c;
+        }
+    }
+    return best;
+}
+
+// an idle core with an empty queue takes the newest process of the longest queue.
+// the affinity policy leaves a single waiting process with the core it belongs to.
+int steal_process(RunQueues *queues, int num, int placement, int thief) {
+    int victim = -1;
+    for (int c = 0; c < num; c++) {
+        if (c != thief && queues->length[c] > 0 && (victim == -1 || queues->length[c] > queues->length[victim])) {
+            victim = c;
+        }
+    }
+    if (victim == -1 || (placement == PLACEMENT_AFFINITY && queues->length[victim] < 2)) {
+        return -1;
+    }
+    int p = queues->tail[victim];
+    run_queue_remove(queues, victim, p);
+    return p;
+}
+
+void pin_to_core(pid_t pid, int core) {
+    static int online = 0;
+    if (online == 0) {
+        online = sysconf(_SC_NPROCESSORS_ONLN);
+        if (online < 1) {
+            online = 1;
+        }
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % online, &set);
+    if (sched_setaffinity(pid, sizeof(set), &set) == -1) {
+        perror("sched_setaffinity failed");
+    }
+}
+
+void print_core_summary(const Core *cores, int num, int makespan) {
+    int len;
+    int total_migrations = 0, total_steals = 0;
+    for (int c = 0; c < num; c++) {
+        len = snprintf(output_buffer, sizeof(output_buffer),
+                       "   ├─ CPU %-2d                  : %.2f%% busy, %d migrations, %d steals\n", c,
+                       makespan > 0 ? 100.0 * cores[c].busyTime / makespan : 0.0, cores[c].migrations,
+                       cores[c].steals);
+        emit_output(output_buffer, len);
+        total_migrations += cores[c].migrations;
+        total_steals += cores[c].steals;
+    }
+    len = snprintf(output_buffer, sizeof(output_buffer),
+                   "   └─ Migrations / Steals     : %d / %d\n", total_migrations, total_steals);
+    emit_output(output_buffer, len);
+}
+
+// Round Robin on num cores. time moves from event to event (a slice ending or a process
+// arriving); at each event finished slices are handled first (core order), then arrivals are
+// placed, then idle cores pick their next process. a line is printed when its slice ends.
+void run_multicore_round_robin(ProcessList *process_list, int num, int placement, int time_quantum) {
+    char scheduler_name[96];
+    snprintf(scheduler_name, sizeof(scheduler_name), "Round Robin (%d cores, %s)", num, placement_name(placement));
+    print_header(scheduler_name);
+
+    int count = process_list->count;
+    int *by_arrival = malloc((count > 0 ? count : 1) * sizeof(int)); // batches get sorted by csv row
+    if (!by_arrival) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(by_arrival, process_list->byArrival, count * sizeof(int));
+    int next_arrival = 0;
+    int arrivals = 0;
+
+    int num_queues = placement == PLACEMENT_GLOBAL ? 1 : num;
+    size_t size = (count > 0 ? count : 1) * sizeof(int);
+    RunQueues queues;
+    queues.head = malloc(num_queues * sizeof(int));
+    queues.tail = malloc(num_queues * sizeof(int));
+    queues.length = calloc(num_queues, sizeof(int));
+    queues.next = malloc(size);
+    queues.prev = malloc(size);
+    int *last_core = malloc(size); // where each process ran last, -1 if it hasn't run
+    Core *cores = calloc(num, sizeof(Core));
+    if (!queues.head || !queues.tail || !queues.length || !queues.next || !queues.prev || !last_core || !cores) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    for (int q = 0; q < num_queues; q++) {
+        queues.head[q] = queues.tail[q] = -1;
+    }
+    for (int i = 0; i < count; i++) {
+        last_core[i] = -1;
+    }
+    for (int c = 0; c < num; c++) {
+        cores[c].running = -1;
+    }
+
+    int current_time = 0;
+    int completed_count = 0;
+
+    while (completed_count < count) {
+        // slices ending now
+        for (int c = 0; c < num; c++) {
+            int p = cores[c].running;
+            if (p == -1 || cores[c].sliceEnd != current_time) {
+                continue;
+            }
+            if (!simulate_mode)
+                stop_child(process_list, p, current_time - cores[c].sliceStart);
+            int len = snprintf(output_buffer, sizeof(output_buffer), "%d → %d: [CPU %d] %s Running %s.\n",
+                               cores[c].sliceStart, current_time, c, process_name(process_list, p),
+                               process_description(process_list, p));
+            emit_output(output_buffer, len);
+            process_list->remainingBurstTime[p] -= current_time - cores[c].sliceStart;
+            cores[c].running = -1;
+            if (process_list->remainingBurstTime[p] <= 0) {
+                finalize_process(process_list, p, &completed_count, &current_time);
+            } else {
+                run_queue_push(&queues, placement == PLACEMENT_GLOBAL ? 0 : c, p);
+            }
+        }
+
+        // arrivals. while every core is busy they wait for the next slice to end and queue up
+        // behind the process it puts back; each batch is placed in csv order, as in run_round_robin
+        int idle_core = 0;
+        for (int c = 0; c < num; c++) {
+            if (cores[c].running == -1) {
+                idle_core = 1;
+                break;
+            }
+        }
+        int first_admitted = next_arrival;
+        while (idle_core && next_arrival < count &&
+               process_list->arrivalTime[by_arrival[next_arrival]] <= current_time) {
+            next_arrival++;
+        }
+        qsort(by_arrival + first_admitted, next_arrival - first_admitted, sizeof(int), compareInt);
+        for (int i = first_admitted; i < next_arrival; i++) {
+            int q = place_arrival(&queues, cores, num, placement, arrivals++);
+            run_queue_push(&queues, q, by_arrival[i]);
+        }
+
+        // idle cores take their next process
+        int next_event = -1;
+        for (int c = 0; c < num; c++) {
+            if (cores[c].running == -1) {
+                int q = placement == PLACEMENT_GLOBAL ? 0 : c;
+                int p = queues.head[q];
+                if (p != -1) {
+                    run_queue_remove(&queues, q, p);
+                } else if (placement != PLACEMENT_GLOBAL) {
+                    p = steal_process(&queues, num, placement, c);
+                    if (p != -1) {
+                        cores[c].steals++;
+                    }
+                }
+                if (p != -1) {
+                    if (last_core[p] != -1 && last_core[p] != c) {
+                        cores[c].migrations++;
+                    }
+                    last_core[p] = c;
+                    if (process_list->startTime[p] == -1) {
+                        process_list->startTime[p] = current_time;
+                    }
+                    int duration = process_list->remainingBurstTime[p];
+                    if (duration > time_quantum) {
+                        duration = time_quantum;
+                    }
+                    cores[c].running = p;
+                    cores[c].sliceStart = current_time;
+                    cores[c].sliceEnd = current_time + duration;
+                    cores[c].busyTime += duration;
+                    if (!simulate_mode) {
+                        if (pin_children) {
+                            pin_to_core(process_list->pid[p], c);
+                        }
+                        continue_child(process_list, p);
+                    }
+                }
+            }
+            if (cores[c].running != -1 && (next_event == -1 || cores[c].sliceEnd < next_event)) {
+                next_event = cores[c].sliceEnd;
+            }
+        }
+
+        if (next_arrival < count) {
+            int arrival = process_list->arrivalTime[by_arrival[next_arrival]];
+            int busy_cores = 0;
+            for (int c = 0; c < num; c++) {
+                busy_cores += cores[c].running != -1;
+            }
+            if (busy_cores == 0) {
+                handle_idle_time(arrival, &current_time);
+                continue;
+            }
+            // an arrival only matters now if a core can take it
+            if (busy_cores < num && arrival < next_event) {
+                next_event = arrival > current_time ? arrival : current_time;
+            }
+        }
+        if (next_event == -1) {
+            break;
+        }
+        pass_time(next_event - current_time);
+        current_time = next_event;
+    }
+
+    print_metrics_summary(process_list, 1);
+    print_core_summary(cores, num, current_time);
+    print_report_end();
+
+    free(queues.head);
+    free(queues.tail);
+    free(queues.length);
+    free(queues.next);
+    free(queues.prev);
+    free(last_core);
+    free(cores);
+    free(by_arrival);
+}
+
+// the algorithms, in the order of the report
+
+#define MAX_ALGORITHMS 8
+
+// the algorithms to run, fills ids and returns how many there are
+int selected_algorithms(int *ids) {
+    int count = 0;
+    if (algorithm_mask) {
+        for (int id = 0; id < MAX_ALGORITHMS; id++) {
+            if (algorithm_mask & (1u << id))
+                ids[count++] = id;
+        }
+        return count;
+    }
+    // fcfs, sjf, priority, round robin
+    for (int id = 0; id < 4; id++) {
+        ids[count++] = id;
+    }
+    if (preemptive_mode) {
+        // srtf, preemptive priority, mlfq
+        for (int id = 4; id < 7; id++) {
+            ids[count++] = id;
+        }
+    }
+    if (num_cores > 0) {
+        ids[count++] = 7;
+    }
+    return count;
+}
+
+const char *algorithm_names[MAX_ALGORITHMS] = {
+    "FCFS", "SJF", "Priority", "Round Robin", "SRTF", "Preemptive Priority", "MLFQ", "Multi-Core Round Robin",
+};
+
+// names accepted by --algorithms, by algorithm id
+const char *algorithm_keys[MAX_ALGORITHMS] = {"fcfs", "sjf", "priority", "rr", "srtf", "pp", "mlfq", "multicore"};
+
+// parse "--algorithms fcfs,rr", returns -1 if the list isn't valid
+int parse_algorithm_list(const char *list) {
+    unsigned mask = 0;
+    const char *cursor = list;
+    while (*cursor) {
+        size_t len = strcspn(cursor, ",");
+        int id = 0;
+        while (id < MAX_ALGORITHMS && (strlen(algorithm_keys[id]) != len || strncmp(cursor, algorithm_keys[id], len)))
+            id++;
+        if (id == MAX_ALGORITHMS) {
+            return -1;
+        }
+        mask |= 1u << id;
+        cursor += cursor[len] == ',' ? len + 1 : len;
+    }
+    if (mask == 0) {
+        return -1;
+    }
+    algorithm_mask = mask;
+    return 0;
+}
+
+// what an algorithm run leaves behind for the metrics export. waiting, turnaround and
+// response time all follow from the start and completion times.
+typedef struct
+{
+    int algorithm;
+    long long elapsedNs; // time spent scheduling (the schedule itself in simulation mode)
+    int *startTime;
+    int *completionTime;
+} AlgorithmMetrics;
+
+void capture_metrics(const ProcessList *processList, int algorithm, long long elapsedNs, AlgorithmMetrics *metrics) {
+    size_t size = (processList->count > 0 ? processList->count : 1) * sizeof(int);
+    metrics->algorithm = algorithm;
+    metrics->elapsedNs = elapsedNs;
+    metrics->startTime = malloc(size);
+    metrics->completionTime = malloc(size);
+    if (!metrics->startTime || !metrics->completionTime) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(metrics->startTime, processList->startTime, processList->count * sizeof(int));
+    memcpy(metrics->completionTime, processList->completionTime, processList->count * sizeof(int));
+}
+
+void free_metrics(AlgorithmMetrics *metrics) {
+    free(metrics->startTime);
+    free(metrics->completionTime);
+}
+
+// metrics: (optional) filled with the run's results before the table is reset
+void run_algorithm(ProcessList *processList, int algorithm, int timeQuantum, AlgorithmMetrics *metrics) {
+    memset(&accounting, 0, sizeof(accounting));
+    forkProcesses(processList); // fork processes
+    long long started = monotonic_ns();
+    switch (algorithm) {
+    case 0:
+        // fcfs
+        run_compare_based_scheduler(processList, compareFCFS, "FCFS");
+        break;
+    case 1:
+        // sjf
+        run_compare_based_scheduler(processList, compareSJF, "SJF");
+        break;
+    case 2:
+        // priority
+        run_compare_based_scheduler(processList, compareProcessesByPriority, "Priority");
+        break;
+    case 3:
+        // round robin
+        run_round_robin(processList, timeQuantum);
+        break;
+    case 4:
+        run_preemptive_scheduler(processList, compareSRTF, "SRTF");
+        break;
+    case 5:
+        run_preemptive_scheduler(processList, compareProcessesByPriority, "Preemptive Priority");
+        break;
+    case 6: {
+        int default_quanta[3] = {timeQuantum, 2 * timeQuantum, 4 * timeQuantum};
+        if (mlfq_levels > 0) {
+            run_mlfq(processList, mlfq_levels, mlfq_quanta, mlfq_aging);
+        } else {
+            run_mlfq(processList, 3, default_quanta, mlfq_aging);
+        }
+        break;
+    }
+    case 7:
+        run_multicore_round_robin(processList, num_cores, placement_policy, timeQuantum);
+        break;
+    }
+    if (metrics)
+        capture_metrics(processList, algorithm, monotonic_ns() - started, metrics);
+    cleanup_process_list(processList); // cleanup processes
+    if (cpu_bound_mode && !simulate_mode)
+        print_accounting(algorithm_names[algorithm]);
+}
+
+// metrics export
+
+// text that grows as needed and is written with as few write calls as possible
+typedef struct
+{
+    char *data;
+    size_t len;
+    size_t capacity;
+} TextBuffer;
+
+void buffer_printf(TextBuffer *buffer, const char *format, ...) {
+    while (1) {
+        va_list args;
+        va_start(args, format);
+        size_t room = buffer->capacity - buffer->len;
+        int len = vsnprintf(buffer->data + buffer->len, room, format, args);
+        va_end(args);
+        if (len < 0) {
+            perror("vsnprintf failed");
+            exit(EXIT_FAILURE);
+        }
+        if ((size_t)len < room) {
+            buffer->len += len;
+            return;
+        }
+        size_t capacity = buffer->capacity ? buffer->capacity * 2 : 65536;
+        while (capacity - buffer->len <= (size_t)len) {
+            capacity *= 2;
+        }
+        buffer->data = grow_array(buffer->data, capacity, 1);
+        buffer->capacity = capacity;
+    }
+}
+
+void buffer_json_string(TextBuffer *buffer, const char *str) {
+    buffer_printf(buffer, "\"");
+    for (const char *c = str; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            buffer_printf(buffer, "\\%c", *c);
+        } else if ((unsigned char)*c < 0x20) {
+            buffer_printf(buffer, "\\u%04x", *c);
+        } else {
+            buffer_printf(buffer, "%c", *c);
+        }
+    }
+    buffer_printf(buffer, "\"");
+}
+
+void buffer_csv_string(TextBuffer *buffer, const char *str) {
+    if (!strpbrk(str, ",\"\r\n")) {
+        buffer_printf(buffer, "%s", str);
+        return;
+    }
+    buffer_printf(buffer, "\"");
+    for (const char *c = str; *c; c++) {
+        buffer_printf(buffer, *c == '"' ? "\"\"" : "%c", *c);
+    }
+    buffer_printf(buffer, "\"");
+}
+
+void write_buffer(const char *path, const TextBuffer *buffer) {
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        perror("Failed to open metrics file");
+        exit(EXIT_FAILURE);
+    }
+    size_t written = 0;
+    while (written < buffer->len) {
+        ssize_t len = write(fd, buffer->data + written, buffer->len - written);
+        if (len == -1) {
+            if (errno == EINTR)
+                continue;
+            perror("Failed to write metrics file");
+            exit(EXIT_FAILURE);
+        }
+        written += len;
+    }
+    close(fd);
+}
+
+// peak resident set of this process in KB (VmHWM), -1 if it can't be read
+long peak_rss_kb() {
+    char status[4096];
+    int fd = open("/proc/self/status", O_RDONLY);
+    if (fd == -1)
+        return -1;
+    ssize_t len = read(fd, status, sizeof(status) - 1);
+    close(fd);
+    if (len <= 0)
+        return -1;
+    status[len] = '\0';
+    char *line = strstr(status, "VmHWM:");
+    return line ? strtol(line + strlen("VmHWM:"), NULL, 10) : -1;
+}
+
+typedef struct
+{
+    double average;
+    int p50;
+    int p95;
+    int p99;
+    int max;
+} Distribution;
+
+// nearest-rank percentiles; sorts values
+Distribution distribution(int *values, int count) {
+    Distribution d = {0};
+    if (count == 0)
+        return d;
+    qsort(values, count, sizeof(int), compareInt);
+    double total = 0;
+    for (int i = 0; i < count; i++) {
+        total += values[i];
+    }
+    d.average = total / count;
+    d.p50 = values[(count * 50 + 99) / 100 - 1];
+    d.p95 = values[(count * 95 + 99) / 100 - 1];
+    d.p99 = values[(count * 99 + 99) / 100 - 1];
+    d.max = values[count - 1];
+    return d;
+}
+
+typedef struct
+{
+    int makespan;               // completion of the last process
+    double cpu_utilization;     // busy share of the cores up to makespan
+    Distribution waiting;
+    Distribution turnaround;
+    Distribution response;
+} MetricsSummary;
+
+MetricsSummary summarize(const ProcessList *processList, const AlgorithmMetrics *metrics, int *scratch) {
+    MetricsSummary summary;
+    int count = processList->count;
+    long long busy = 0;
+    summary.makespan = 0;
+    for (int i = 0; i < count; i++) {
+        busy += processList->burstTime[i];
+        if (metrics->completionTime[i] > summary.makespan)
+            summary.makespan = metrics->completionTime[i];
+    }
+    int cores = metrics->algorithm == 7 ? num_cores : 1;
+    summary.cpu_utilization = summary.makespan > 0 ? (double)busy / ((double)summary.makespan * cores) : 0;
+
+    for (int i = 0; i < count; i++)
+        scratch[i] = metrics->completionTime[i] - processList->arrivalTime[i] - processList->burstTime[i];
+    summary.waiting = distribution(scratch, count);
+    for (int i = 0; i < count; i++)
+        scratch[i] = metrics->completionTime[i] - processList->arrivalTime[i];
+    summary.turnaround = distribution(scratch, count);
+    for (int i = 0; i < count; i++)
+        scratch[i] = metrics->startTime[i] - processList->arrivalTime[i];
+    summary.response = distribution(scratch, count);
+    return summary;
+}
+
+void buffer_json_distribution(TextBuffer *buffer, const char *name, const Distribution *d, const char *separator) {
+    buffer_printf(buffer, "      \"%s\": {\"avg\": %.2f, \"p50\": %d, \"p95\": %d, \"p99\": %d, \"max\": %d}%s\n",
+                  name, d->average, d->p50, d->p95, d->p99, d->max, separator);
+}
+
+// json: every algorithm with its summary and per-process times.
+// csv: one row per algorithm and process, and the summaries in <name>_summary.csv
+// (--metrics-summary: only the summaries, in <name> itself)
+void export_metrics(const char *path, const ProcessList *processList, const AlgorithmMetrics *metrics, int count) {
+    int *scratch = malloc((processList->count > 0 ? processList->count : 1) * sizeof(int));
+    if (!scratch) {
+        perror("malloc failed");
+        exit(EXIT_FAILURE);
+    }
+    TextBuffer out = {0};
+    TextBuffer summaries = {0};
+    int json = has_suffix(path, ".json");
+
+    if (json) {
+        buffer_printf(&out, "{\n  \"peak_rss_kb\": %ld,\n  \"algorithms\": [\n", peak_rss_kb());
+    } else {
+        buffer_printf(&out, "algorithm,process,arrival,burst,priority,start,completion,waiting,turnaround,response\n");
+        buffer_printf(&summaries, "algorithm,processes,elapsed_ms,makespan,cpu_utilization");
+        const char *names[3] = {"waiting", "turnaround", "response"};
+        for (int k = 0; k < 3; k++) {
+            buffer_printf(&summaries, ",%s_avg,%s_p50,%s_p95,%s_p99,%s_max", names[k], names[k], names[k], names[k],
+                          names[k]);
+        }
+        buffer_printf(&summaries, "\n");
+    }
+
+    for (int a = 0; a < count; a++) {
+        const AlgorithmMetrics *m = &metrics[a];
+        const char *name = algorithm_names[m->algorithm];
+        MetricsSummary summary = summarize(processList, m, scratch);
+        if (json) {
+            buffer_printf(&out, "    {\n      \"name\": ");
+            buffer_json_string(&out, name);
+            buffer_printf(&out, ",\n      \"elapsed_ms\": %.3f,\n      \"makespan\": %d,\n      \"cpu_utilization\": %.4f,\n",
+                          m->elapsedNs / 1e6, summary.makespan, summary.cpu_utilization);
+            buffer_json_distribution(&out, "waiting", &summary.waiting, ",");
+            buffer_json_distribution(&out, "turnaround", &summary.turnaround, ",");
+            buffer_json_distribution(&out, "response", &summary.response, metrics_summary_only ? "" : ",");
+            if (!metrics_summary_only)
+                buffer_printf(&out, "      \"processes\": [\n");
+        } else {
+            buffer_csv_string(&summaries, name);
+            buffer_printf(&summaries, ",%d,%.3f,%d,%.4f", processList->count, m->elapsedNs / 1e6, summary.makespan,
+                          summary.cpu_utilization);
+            const Distribution *ds[3] = {&summary.waiting, &summary.turnaround, &summary.response};
+            for (int k = 0; k < 3; k++) {
+                buffer_printf(&summaries, ",%.2f,%d,%d,%d,%d", ds[k]->average, ds[k]->p50, ds[k]->p95, ds[k]->p99,
+                              ds[k]->max);
+            }
+            buffer_printf(&summaries, "\n");
+        }
+
+        for (int i = 0; i < (metrics_summary_only ? 0 : processList->count); i++) {
+            int arrival = processList->arrivalTime[i];
+            int turnaround = m->completionTime[i] - arrival;
+            if (json) {
+                buffer_printf(&out, "        {\"name\": ");
+                buffer_json_string(&out, process_name(processList, i));
+                buffer_printf(&out,
+                              ", \"arrival\": %d, \"burst\": %d, \"priority\": %d, \"start\": %d, "
+                              "\"completion\": %d, \"waiting\": %d, \"turnaround\": %d, \"response\": %d}%s\n",
+                              arrival, processList->burstTime[i], processList->priority[i], m->startTime[i],
+                              m->completionTime[i], turnaround - processList->burstTime[i], turnaround,
+                              m->startTime[i] - arrival, i + 1 < processList->count ? "," : "");
+            } else {
+                buffer_csv_string(&out, name);
+                buffer_printf(&out, ",");
+                buffer_csv_string(&out, process_name(processList, i));
+                buffer_printf(&out, ",%d,%d,%d,%d,%d,%d,%d,%d\n", arrival, processList->burstTime[i],
+                              processList->priority[i], m->startTime[i], m->completionTime[i],
+                              turnaround - processList->burstTime[i], turnaround, m->startTime[i] - arrival);
+            }
+        }
+        if (json) {
+            buffer_printf(&out, "%s    }%s\n", metrics_summary_only ? "" : "      ]\n", a + 1 < count ? "," : "");
+        }
+    }
+
+    if (json) {
+        buffer_printf(&out, "  ]\n}\n");
+    }
+    if (json || !metrics_summary_only)
+        write_buffer(path, &out);
+    if (!json && metrics_summary_only) {
+        write_buffer(path, &summaries);
+    } else if (!json) {
+        // metrics.csv -> metrics_summary.csv
+        size_t len = strlen(path);
+        size_t stem = has_suffix(path, ".csv") ? len - 4 : len;
+        char *summary_path = malloc(len + 16);
+        if (!summary_path) {
+            perror("malloc failed");
+            exit(EXIT_FAILURE);
+        }
+        snprintf(summary_path, len + 16, "%.*s_summary.csv", (int)stem, path);
+        write_buffer(summary_path, &summaries);
+        free(summary_path);
+    }
+    free(out.data);
+    free(summaries.data);
+    free(scratch);
+}
+
+// parallel mode (--parallel): every algorithm runs in its own worker process, with its own
+// clock (alarm), children and copy of the process table. a worker's report goes to a
+// temporary file and the reports are printed in the usual order once all workers are done,
+// so the output is the same as running them one after another.
+// metrics: (optional) one entry per algorithm, sent back by the workers through their report
+// files after the report text
+void run_algorithms_in_parallel(ProcessList *processList, int timeQuantum, AlgorithmMetrics *metrics) {
+    pid_t workers[MAX_ALGORITHMS];
+    FILE *reports[MAX_ALGORITHMS];
+    int ids[MAX_ALGORITHMS];
+    int count = selected_algorithms(ids);
+    size_t metrics_size = (size_t)processList->count * sizeof(int);
+
+    fflush(stdout); // don't let the workers inherit buffered output
+    for (int a = 0; a < count; a++) {
+        reports[a] = tmpfile();
+        if (!reports[a]) {
+            perror("tmpfile failed");
+            exit(EXIT_FAILURE);
+        }
+        workers[a] = fork();
+        if (workers[a] < 0) {
+            perror("Fork failed");
+            exit(EXIT_FAILURE);
+        }
+        if (workers[a] == 0) {
+            // worker: the report goes to its file instead of stdout
+            if (dup2(fileno(reports[a]), STDOUT_FILENO) == -1) {
+                perror("dup2 failed");
+                _exit(EXIT_FAILURE);
+            }
+            AlgorithmMetrics result;
+            run_algorithm(processList, ids[a], timeQuantum, metrics ? &result : NULL);
+            fflush(stdout);
+            // the start and completion times go at the end of the file, the parent takes them off
+            if (metrics) {
+                if (write(STDOUT_FILENO, &result.elapsedNs, sizeof(long long)) != sizeof(long long) ||
+                    write(STDOUT_FILENO, result.startTime, metrics_size) != (ssize_t)metrics_size ||
+                    write(STDOUT_FILENO, result.completionTime, metrics_size) != (ssize_t)metrics_size) {
+                    perror("Failed to write metrics");
+                    _exit(EXIT_FAILURE);
+                }
+            }
+            _exit(0);
+        }
+    }
+
+    int failed = 0;
+    for (int a = 0; a < count; a++) {
+        int status;
+        if (waitpid(workers[a], &status, 0) == -1 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "Scheduler worker %d failed\n", a);
+            failed = 1;
+        }
+    }
+
+    // print the reports in order
+    for (int a = 0; a < count; a++) {
+        int fd = fileno(reports[a]);
+        off_t report_len = lseek(fd, 0, SEEK_END);
+        if (metrics && !failed) {
+            report_len -= sizeof(long long) + 2 * metrics_size;
+            metrics[a].algorithm = ids[a];
+            metrics[a].startTime = malloc(metrics_size > 0 ? metrics_size : 1);
+            metrics[a].completionTime = malloc(metrics_size > 0 ? metrics_size : 1);
+            off_t at = report_len + sizeof(long long);
+            if (!metrics[a].startTime || !metrics[a].completionTime ||
+                pread(fd, &metrics[a].elapsedNs, sizeof(long long), report_len) != sizeof(long long) ||
+                pread(fd, metrics[a].startTime, metrics_size, at) != (ssize_t)metrics_size ||
+                pread(fd, metrics[a].completionTime, metrics_size, at + metrics_size) != (ssize_t)metrics_size) {
+                perror("Failed to read metrics");
+                exit(EXIT_FAILURE);
+            }
+        }
+        if (report_len < 0 || lseek(fd, 0, SEEK_SET) == -1) {
+            perror("lseek failed");
+            exit(EXIT_FAILURE);
+        }
+        ssize_t len = 0;
+        off_t left = report_len;
+        while (left > 0 &&
+               (len = read(fd, output_buffer, left < (off_t)sizeof(output_buffer) ? left : (off_t)sizeof(output_buffer))) > 0) {
+            emit_output(output_buffer, len);
+            left -= len;
+        }
+        if (len == -1) {
+            perror("read failed");
+            exit(EXIT_FAILURE);
+        }
+        fclose(reports[a]);
+    }
+
+    if (failed) {
+        fflush(stdout);
+        exit(EXIT_FAILURE);
+    }
+}
+
 void runCPUScheduler(char *processesCsvFilePath, int timeQuantum) {
 
     ProcessList processList = {0};
     readProcessesFromCsv(processesCsvFilePath, &processList);
 
     // setup the alarm handler
-    setup_alarm_handler();
+    if (!simulate_mode)
+        setup_alarm_handler();
 
     // scheduling algorithms
-    // fcfs
-    run_scheduler_with_setup(&processList, compareFCFS, "FCFS");
-    // sjf
-    run_scheduler_with_setup(&processList, compareSJF, "SJF");
-    // priority
-    run_scheduler_with_setup(&processList, compareProcessesByPriority, "Priority");
-
-    // round robin
-    forkProcesses(&processList); // fork processes for round robin
-    run_round_robin(&processList, timeQuantum);
-    cleanup_process_list(&processList); // cleanup processes after round robin
-
-}
\ No newline at end of file
+    AlgorithmMetrics metrics[MAX_ALGORITHMS];
+    int ids[MAX_ALGORITHMS];
+    int count = selected_algorithms(ids);
+    if (parallel_mode) {
+        run_algorithms_in_parallel(&processList, timeQuantum, metrics_path ? metrics : NULL);
+    } else {
+        for (int a = 0; a < count; a++) {
+            run_algorithm(&processList, ids[a], timeQuantum, metrics_path ? &metrics[a] : NULL);
+        }
+    }
+
+    fflush(stdout);
+    if (metrics_path) {
+        export_metrics(metrics_path, &processList, metrics, count);
+        for (int a = 0; a < count; a++) {
+            free_metrics(&metrics[a]);
+        }
+    }
+    free_process_list(&processList);
+}
@@ -1,25 +1,134 @@
 #include <signal.h>
 #include <unistd.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
 
 #define EMAIL_SIGNAL SIGUSR1
 #define DELIVERY_SIGNAL SIGUSR2
 #define DOORBELL_SIGNAL SIGPIPE
 
+// distraction types: everything the menu, the pending phase and the handler know about a
+// distraction. adding one is adding an entry.
+// - signal: sent by the menu, a standard signal (they collapse: pending once however often it came)
+// - queued_offset: external distractions (./ex3 Distract) are sent as SIGRTMIN + queued_offset,
+//   real-time signals are queued one by one. the value carries the time the sender sent it
+//   (CLOCK_MONOTONIC, in microseconds).
+// - priority: pending distractions are delivered by ascending priority
+typedef struct
+{
+    char key;
+    const char *label;
+    int signal;
+    int queued_offset;
+    int priority;
+    const char *pending_message;
+    const char *outcome;
+} DistractionType;
+
+const DistractionType distraction_types[] = {
+    {'1', "Email notification", EMAIL_SIGNAL, 0, 1, " - Email notification is waiting.\n",
+     "[Outcome:] The TA announced: Everyone get 100 on the exercise!\n"},
+    {'2', "Reminder to pick up delivery", DELIVERY_SIGNAL, 1, 2, " - You have a reminder to pick up your delivery.\n",
+     "[Outcome:] You picked it up just in time.\n"},
+    {'3', "Doorbell Ringing", DOORBELL_SIGNAL, 2, 3, " - The doorbell is ringing.\n",
+     "[Outcome:] Food delivery is here.\n"},
+};
+
+#define NUM_DISTRACTION_TYPES ((int)(sizeof(distraction_types) / sizeof(distraction_types[0])))
+
+// signal number -> index in distraction_types, -1 for other signals
+int distraction_by_signal[_NSIG];
+// indexes in distraction_types by ascending priority
+int delivery_order[NUM_DISTRACTION_TYPES];
+// all the distraction signals, standard and queued
+sigset_t distraction_mask;
+
+int queued_signal(const DistractionType *type) {
+    return SIGRTMIN + type->queued_offset;
+}
+
+// build the lookups once (SIGRTMIN is only known at run time)
+void init_distraction_types() {
+    sigemptyset(&distraction_mask);
+    for (int sig = 0; sig < _NSIG; sig++) {
+        distraction_by_signal[sig] = -1;
+    }
+    for (int t = 0; t < NUM_DISTRACTION_TYPES; t++) {
+        const DistractionType *type = &distraction_types[t];
+        distraction_by_signal[type->signal] = t;
+        distraction_by_signal[queued_signal(type)] = t;
+        sigaddset(&distraction_mask, type->signal);
+        sigaddset(&distraction_mask, queued_signal(type));
+
+        // insertion sort, equal priorities keep table order
+        int at = t;
+        while (at > 0 && distraction_types[delivery_order[at - 1]].priority > type->priority) {
+            delivery_order[at] = delivery_order[at - 1];
+            at--;
+        }
+        delivery_order[at] = t;
+    }
+}
+
+// a queued distraction, kept until the end of the round
+typedef struct
+{
+    int type;
+    pid_t source;
+    long long sent_us;
+    long long received_us;
+} DistractionRecord;
+
+// what reached the focus loop of one distraction type during the round
+typedef struct
+{
+    int pending;         // the standard signal came (any number of times)
+    long queued;         // queued (external) ones
+    pid_t last_source;
+    long long oldest_sent_us;
+} DistractionStats;
+
+// --timed: a round lasts duration seconds instead of duration inputs
+int timed_rounds = 0;
+
+// the focus mode waits in one epoll set for input (stdin), distractions (a signalfd, the
+// signals stay blocked the whole time) and the end of the round (a timerfd, with --timed).
+// every event is handled synchronously by the loop, no handler runs in between.
+typedef struct
+{
+    int epoll_fd;
+    int signal_fd;
+    int timer_fd;
+    int input_polled;  // stdin is in the epoll set (not a regular file)
+    int input_closed;  // stdin reached end of file
+    char input[256];
+    size_t input_len;
+    size_t input_pos;
+    DistractionStats stats[NUM_DISTRACTION_TYPES];
+    DistractionRecord *queued; // external distractions of the round, in arrival order
+    size_t queued_count;
+    size_t queued_capacity;
+} FocusLoop;
+
+
 void async_safe_write(const char *msg) {
     write(STDERR_FILENO, msg, strlen(msg));
 }
 
 // handlers
 
+// the outcome of a distraction that arrives after focus mode ended (the loop itself writes
+// the outcomes of the pending ones)
 void handle_signal(int signum) {
-    if (signum == EMAIL_SIGNAL) {
-        async_safe_write("[Outcome:] The TA announced: Everyone get 100 on the exercise!\n");
-    } else if (signum == DELIVERY_SIGNAL) {
-        async_safe_write("[Outcome:] You picked it up just in time.\n");
-    } else if (signum == DOORBELL_SIGNAL) {
-        async_safe_write("[Outcome:] Food delivery is here.\n");
+    if (signum > 0 && signum < _NSIG && distraction_by_signal[signum] != -1) {
+        async_safe_write(distraction_types[distraction_by_signal[signum]].outcome);
     }
 }
 
@@ -29,9 +138,10 @@ void setupSignalHandlers() {
     sa.sa_handler = handle_signal;
     sigfillset(&sa.sa_mask);
     sa.sa_flags = 0;
-    sigaction(EMAIL_SIGNAL, &sa, NULL);
-    sigaction(DELIVERY_SIGNAL, &sa, NULL);
-    sigaction(DOORBELL_SIGNAL, &sa, NULL);
+    for (int t = 0; t < NUM_DISTRACTION_TYPES; t++) {
+        sigaction(distraction_types[t].signal, &sa, NULL);
+        sigaction(queued_signal(&distraction_types[t]), &sa, NULL);
+    }
 }
 
 void printRoundStart(int roundNumber) {
@@ -53,99 +163,384 @@ void printBackToFocusMode() {
 void printDistractionMenu() {
     printf("\n");
     printf("Simulate a distraction:\n");
-    printf("  1 = Email notification\n");
-    printf("  2 = Reminder to pick up delivery\n");
-    printf("  3 = Doorbell Ringing\n");
+    for (int t = 0; t < NUM_DISTRACTION_TYPES; t++) {
+        printf("  %c = %s\n", distraction_types[t].key, distraction_types[t].label);
+    }
     printf("  q = Quit\n");
     printf(">> ");
 } 
 
+long long monotonic_us() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000LL + now.tv_nsec / 1000;
+}
+
+// latency instrumentation (--latency): how long every distraction waited between being sent
+// and its outcome, as a log2 histogram per type, and how long each round spent in the menu
+// and in the pending phase. reported on stderr at the end of the run.
+int latency_mode = 0;
+
+#define LATENCY_BUCKETS 40    // bucket b: [2^b, 2^(b+1)) microseconds, bucket 0 also has 0
+#define MENU_SEND_RING 1024   // menu sends waiting for their outcome
+
+typedef struct
+{
+    long count;
+    long long total_us;
+    long long max_us;
+    long buckets[LATENCY_BUCKETS];
+} LatencyHistogram;
+
+typedef struct
+{
+    long long menu_us;     // from the start of the round to the pending phase
+    long long pending_us;  // the pending phase
+    long delivered;        // distractions (sends) it delivered
+} RoundTiming;
+
+typedef struct
+{
+    int signal;
+    long long sent_us;
+} MenuSend;
+
+LatencyHistogram latency_by_type[NUM_DISTRACTION_TYPES];
+RoundTiming *round_timings = NULL;
+int timed_round_count = 0;
+// the menu's sends of the current round; when it's full the oldest ones are dropped
+MenuSend menu_sends[MENU_SEND_RING];
+long menu_send_count = 0;
+long menu_sends_dropped = 0;
+
+void record_latency(int type, long long latency_us) {
+    LatencyHistogram *histogram = &latency_by_type[type];
+    if (latency_us < 0)
+        latency_us = 0;
+    int bucket = 0;
+    while (bucket + 1 < LATENCY_BUCKETS && (latency_us >> (bucket + 1)) > 0)
+        bucket++;
+    histogram->buckets[bucket]++;
+    histogram->count++;
+    histogram->total_us += latency_us;
+    if (latency_us > histogram->max_us)
+        histogram->max_us = latency_us;
+}
+
+void format_us(long long us, char *text, size_t size) {
+    if (us < 1000) {
+        snprintf(text, size, "%lld us", us);
+    } else if (us < 1000000) {
+        snprintf(text, size, "%.1f ms", us / 1e3);
+    } else {
+        snprintf(text, size, "%.2f s", us / 1e6);
+    }
+}
+
+void print_latency_report() {
+    char low[32], high[32], average[32], max[32];
+    fprintf(stderr, "\nDistraction latency (sent -> outcome):\n");
+    for (int t = 0; t < NUM_DISTRACTION_TYPES; t++) {
+        const LatencyHistogram *histogram = &latency_by_type[t];
+        if (histogram->count == 0) {
+            fprintf(stderr, "  %s: none\n", distraction_types[t].label);
+            continue;
+        }
+        format_us(histogram->total_us / histogram->count, average, sizeof(average));
+        format_us(histogram->max_us, max, sizeof(max));
+        fprintf(stderr, "  %s: %ld delivered, avg %s, max %s\n", distraction_types[t].label, histogram->count,
+                average, max);
+        long most = 0;
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            if (histogram->buckets[b] > most)
+                most = histogram->buckets[b];
+        }
+        for (int b = 0; b < LATENCY_BUCKETS; b++) {
+            if (histogram->buckets[b] == 0)
+                continue;
+            format_us(b == 0 ? 0 : 1LL << b, low, sizeof(low));
+            format_us(1LL << (b + 1), high, sizeof(high));
+            int bar = (int)((histogram->buckets[b] * 40 + most - 1) / most);
+            fprintf(stderr, "    [%9s, %9s) %8ld %.*s\n", low, high, histogram->buckets[b], bar,
+                    "########################################");
+        }
+    }
+    if (menu_sends_dropped > 0) {
+        fprintf(stderr, "  (%ld menu sends not timed, too many in one round)\n", menu_sends_dropped);
+    }
+
+    fprintf(stderr, "\nRound timings:\n");
+    fprintf(stderr, "  %5s %12s %12s %10s\n", "round", "menu ms", "pending ms", "delivered");
+    for (int i = 0; i < timed_round_count; i++) {
+        fprintf(stderr, "  %5d %12.3f %12.3f %10ld\n", i + 1, round_timings[i].menu_us / 1e3,
+                round_timings[i].pending_us / 1e3, round_timings[i].delivered);
+    }
+}
+
 // generic send signal function
 void sendSignal(int sig) {
+    if (latency_mode) {
+        if (menu_send_count == MENU_SEND_RING) {
+            memmove(menu_sends, menu_sends + 1, (MENU_SEND_RING - 1) * sizeof(MenuSend));
+            menu_send_count--;
+            menu_sends_dropped++;
+        }
+        menu_sends[menu_send_count].signal = sig;
+        menu_sends[menu_send_count++].sent_us = monotonic_us();
+    }
     if (kill(getpid(), sig) == -1) {
         perror("Failed to send signal");
     }
 }
 
 
-void distractionMenu(int duration) {
-    char choice;
-    for (int i = 0; i < duration; i++) {
-        printDistractionMenu();
-        scanf(" %c", &choice);
-        switch (choice) {
-            case '1':
-                sendSignal(EMAIL_SIGNAL);
-                break;
-            case '2':
-                sendSignal(DELIVERY_SIGNAL);
-                break;
-            case '3':
-                sendSignal(DOORBELL_SIGNAL);
-                break;
-            case 'q':
-                return;
-            default:
-                printf("Invalid choice.\n");
+// focus loop
+
+int watch_fd(FocusLoop *loop, int fd) {
+    struct epoll_event event = {.events = EPOLLIN, .data.fd = fd};
+    return epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &event);
+}
+
+int open_focus_loop(FocusLoop *loop) {
+    memset(loop->stats, 0, sizeof(loop->stats));
+    loop->queued = NULL;
+    loop->queued_count = loop->queued_capacity = 0;
+    loop->input_len = loop->input_pos = 0;
+    loop->input_closed = 0;
+    loop->timer_fd = -1;
+    loop->signal_fd = signalfd(-1, &distraction_mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->signal_fd == -1 || loop->epoll_fd == -1 || watch_fd(loop, loop->signal_fd) == -1) {
+        perror("Failed to set up the focus loop");
+        return -1;
+    }
+    // epoll can't watch a regular file (input redirected from a file), it's always readable
+    loop->input_polled = watch_fd(loop, STDIN_FILENO) == 0;
+    if (!loop->input_polled && errno != EPERM) {
+        perror("Failed to watch stdin");
+        return -1;
+    }
+    if (timed_rounds) {
+        loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (loop->timer_fd == -1 || watch_fd(loop, loop->timer_fd) == -1) {
+            perror("Failed to create the round timer");
+            return -1;
         }
     }
-    
+    return 0;
 }
 
-// start focus mode, block all signals
-void startFocusMode() {
-    sigset_t sigset;
-    sigemptyset(&sigset);
-    sigaddset(&sigset, EMAIL_SIGNAL);
-    sigaddset(&sigset, DELIVERY_SIGNAL);
-    sigaddset(&sigset, DOORBELL_SIGNAL);
+void close_focus_loop(FocusLoop *loop) {
+    close(loop->epoll_fd);
+    close(loop->signal_fd);
+    if (loop->timer_fd != -1)
+        close(loop->timer_fd);
+    free(loop->queued);
+}
 
-    if (sigprocmask(SIG_BLOCK, &sigset, NULL) != 0) {
-        perror("Failed to block signals");
+const DistractionRecord *queue_distraction(FocusLoop *loop, int type, const struct signalfd_siginfo *info,
+                                           long long received_us) {
+    if (loop->queued_count == loop->queued_capacity) {
+        size_t capacity = loop->queued_capacity ? loop->queued_capacity * 2 : 1024;
+        DistractionRecord *grown = realloc(loop->queued, capacity * sizeof(DistractionRecord));
+        if (!grown) {
+            perror("realloc failed");
+            exit(EXIT_FAILURE);
+        }
+        loop->queued = grown;
+        loop->queued_capacity = capacity;
     }
+    DistractionRecord *record = &loop->queued[loop->queued_count++];
+    record->type = type;
+    record->source = info->ssi_pid;
+    // sent with sigqueue: the sender's timestamp, otherwise all we know is when it got here
+    record->sent_us = info->ssi_code == SI_QUEUE ? (long long)info->ssi_ptr : received_us;
+    record->received_us = received_us;
+    return record;
 }
 
-void unblock_signal(int signum) {
-    sigset_t sigset;
-    sigemptyset(&sigset);
-    sigaddset(&sigset, signum);
+// take every distraction that arrived so far off the signalfd.
+// standard signals aren't queued, so a distraction that came twice is still pending once;
+// every real-time one is recorded.
+void collect_distractions(FocusLoop *loop) {
+    struct signalfd_siginfo info[64];
+    ssize_t len;
+    while ((len = read(loop->signal_fd, info, sizeof(info))) > 0) {
+        long long received_us = monotonic_us();
+        for (size_t i = 0; i < len / sizeof(info[0]); i++) {
+            int signum = info[i].ssi_signo;
+            int type = distraction_by_signal[signum];
+            DistractionStats *stats = &loop->stats[type];
+            if (signum != distraction_types[type].signal) {
+                const DistractionRecord *record = queue_distraction(loop, type, &info[i], received_us);
+                if (stats->queued == 0 || record->sent_us < stats->oldest_sent_us)
+                    stats->oldest_sent_us = record->sent_us;
+                stats->last_source = record->source;
+                stats->queued++;
+            } else {
+                stats->pending = 1;
+            }
+        }
+    }
+    if (len == -1 && errno != EAGAIN && errno != EINTR) {
+        perror("Failed to read distractions");
+    }
+}
 
-    if (sigprocmask(SIG_UNBLOCK, &sigset, NULL) != 0) {
-        perror("Failed to unblock signals");
+void set_round_timer(FocusLoop *loop, int seconds) {
+    if (loop->timer_fd == -1)
+        return;
+    struct itimerspec spec = {0};
+    spec.it_value.tv_sec = seconds;
+    if (seconds > 0 && timerfd_settime(loop->timer_fd, 0, &spec, NULL) == -1) {
+        perror("Failed to start the round timer");
+    }
+    if (seconds == 0) {
+        // stop it and drop an expiration nobody looked at
+        uint64_t expirations;
+        timerfd_settime(loop->timer_fd, 0, &spec, NULL);
+        read(loop->timer_fd, &expirations, sizeof(expirations));
     }
 }
 
-int check_member(int sig, sigset_t *sigset) {
-    if (sigismember(sigset, sig)) {
-        return 1; // Signal is blocked
-    } else {
-        return 0; // Signal is not blocked
+// next non-blank character already read from stdin, 0 if there is none
+char buffered_choice(FocusLoop *loop) {
+    while (loop->input_pos < loop->input_len) {
+        char c = loop->input[loop->input_pos++];
+        if (c != ' ' && c != '\t' && c != '\n' && c != '\r') {
+            return c;
+        }
     }
+    return 0;
+}
 
+void read_input(FocusLoop *loop) {
+    ssize_t len = read(STDIN_FILENO, loop->input, sizeof(loop->input));
+    if (len == -1 && errno == EINTR)
+        return;
+    loop->input_pos = 0;
+    loop->input_len = len > 0 ? len : 0;
+    if (len <= 0) {
+        // end of input: nothing but the timer (and distractions) can end a round from now on
+        loop->input_closed = 1;
+        if (loop->input_polled)
+            epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+    }
 }
 
-void pendingPhase() {
-    printPendingDistractions();
-    sigset_t sigset;
-    int distraction_count = 0;
-    if (sigpending(&sigset) != 0) {
-        perror("sigpending() error\n");
+#define FOCUS_CHOICE 1
+#define FOCUS_TIME_UP 0
+#define FOCUS_NO_INPUT (-1)
+
+// wait for the next choice, handling distractions and the round timer on the way
+int wait_for_choice(FocusLoop *loop, char *choice) {
+    while (1) {
+        if ((*choice = buffered_choice(loop)) != 0) {
+            return FOCUS_CHOICE;
+        }
+        if (loop->input_closed && loop->timer_fd == -1) {
+            return FOCUS_NO_INPUT;
+        }
+        // an unpolled stdin is always ready, only look at what's already there
+        int always_ready = !loop->input_polled && !loop->input_closed;
+        struct epoll_event events[3];
+        int count = epoll_wait(loop->epoll_fd, events, 3, always_ready ? 0 : -1);
+        if (count == -1 && errno != EINTR) {
+            perror("epoll_wait failed");
+            return FOCUS_NO_INPUT;
+        }
+        int input_ready = always_ready;
+        for (int i = 0; i < count; i++) {
+            if (events[i].data.fd == loop->signal_fd) {
+                collect_distractions(loop);
+            } else if (events[i].data.fd == loop->timer_fd) {
+                set_round_timer(loop, 0);
+                return FOCUS_TIME_UP;
+            } else {
+                input_ready = 1;
+            }
+        }
+        if (input_ready) {
+            read_input(loop);
+        }
     }
-    if (check_member(EMAIL_SIGNAL, &sigset)) {
-        printf(" - Email notification is waiting.\n");
-        unblock_signal(EMAIL_SIGNAL);
-        distraction_count++;
+}
+
+void distractionMenu(FocusLoop *loop, int duration) {
+    char choice;
+    for (int i = 0; timed_rounds || i < duration; i++) {
+        printDistractionMenu();
+        fflush(stdout);
+        int event = wait_for_choice(loop, &choice);
+        if (event == FOCUS_TIME_UP) {
+            printf("\n");
+            return;
+        }
+        if (event == FOCUS_NO_INPUT) {
+            return;
+        }
+        if (choice == 'q') {
+            return;
+        }
+        int t = 0;
+        while (t < NUM_DISTRACTION_TYPES && distraction_types[t].key != choice)
+            t++;
+        if (t < NUM_DISTRACTION_TYPES) {
+            sendSignal(distraction_types[t].signal);
+        } else {
+            printf("Invalid choice.\n");
+        }
     }
-    if (check_member(DELIVERY_SIGNAL, &sigset)) {
-        printf(" - You have a reminder to pick up your delivery.\n");
-        unblock_signal(DELIVERY_SIGNAL);
-        distraction_count++;
+}
+
+// start focus mode, block all signals (they're only read through the signalfd)
+void startFocusMode() {
+    if (sigprocmask(SIG_BLOCK, &distraction_mask, NULL) != 0) {
+        perror("Failed to block signals");
     }
-    if (check_member(DOORBELL_SIGNAL, &sigset)) {
-        printf(" - The doorbell is ringing.\n");
-        unblock_signal(DOORBELL_SIGNAL);
+}
+
+// one outcome per distraction type, however many of them are waiting, by priority.
+// the queued (external) ones are counted, with the latest sender and how long the oldest waited.
+// round_timing: (optional) gets the number of distractions delivered
+void pendingPhase(FocusLoop *loop, RoundTiming *round_timing) {
+    printPendingDistractions();
+    int distraction_count = 0;
+    long long delivered_us[NUM_DISTRACTION_TYPES] = {0};
+    collect_distractions(loop);
+    long long now_us = monotonic_us();
+    for (int i = 0; i < NUM_DISTRACTION_TYPES; i++) {
+        const DistractionType *type = &distraction_types[delivery_order[i]];
+        const DistractionStats *stats = &loop->stats[delivery_order[i]];
+        if (!stats->pending && stats->queued == 0) {
+            continue;
+        }
+        printf("%s", type->pending_message);
+        if (stats->queued > 0) {
+            printf("   └─ %ld queued, last from pid %d, the oldest sent %.3f s ago\n", stats->queued,
+                   stats->last_source, (now_us - stats->oldest_sent_us) / 1e6);
+        }
+        fflush(stdout); // the outcome goes to stderr
+        async_safe_write(type->outcome);
+        delivered_us[delivery_order[i]] = monotonic_us();
         distraction_count++;
     }
+    if (latency_mode) {
+        // every send waited until the outcome of its type, also the ones that collapsed
+        for (long i = 0; i < menu_send_count; i++) {
+            int type = distraction_by_signal[menu_sends[i].signal];
+            record_latency(type, delivered_us[type] - menu_sends[i].sent_us);
+        }
+        for (size_t i = 0; i < loop->queued_count; i++) {
+            const DistractionRecord *record = &loop->queued[i];
+            record_latency(record->type, delivered_us[record->type] - record->sent_us);
+        }
+        if (round_timing)
+            round_timing->delivered = menu_send_count + loop->queued_count;
+        menu_send_count = 0;
+    }
+    memset(loop->stats, 0, sizeof(loop->stats));
+    loop->queued_count = 0;
 
     if (distraction_count == 0) {
         printf("No distractions reached you this round.\n");
@@ -155,15 +550,85 @@ void pendingPhase() {
 
 
 void runFocusMode(int numOfRounds, int duration) {
+    FocusLoop loop;
+    init_distraction_types();
     setupSignalHandlers();
+    startFocusMode();
+    if (open_focus_loop(&loop) == -1) {
+        return;
+    }
+    if (latency_mode) {
+        round_timings = calloc(numOfRounds > 0 ? numOfRounds : 1, sizeof(RoundTiming));
+        if (!round_timings) {
+            perror("calloc failed");
+            return;
+        }
+    }
     printf("Entering Focus Mode. All distractions are blocked.\n");
     for (int i = 0; i < numOfRounds; i++) {
-        startFocusMode();
+        RoundTiming *timing = latency_mode ? &round_timings[i] : NULL;
+        long long round_start = monotonic_us();
         printRoundStart(i + 1);
-        distractionMenu(duration);
-        pendingPhase();
-        // sleep(duration);
+        set_round_timer(&loop, duration);
+        distractionMenu(&loop, duration);
+        set_round_timer(&loop, 0);
+        long long pending_start = monotonic_us();
+        pendingPhase(&loop, timing);
+        if (timing) {
+            timing->menu_us = pending_start - round_start;
+            timing->pending_us = monotonic_us() - pending_start;
+            timed_round_count = i + 1;
+        }
         printBackToFocusMode();
     }
+    // distractions that came in after the last pending phase are still pending: they reach
+    // handle_signal (one outcome per queued signal) once they're unblocked
+    close_focus_loop(&loop);
+    sigprocmask(SIG_UNBLOCK, &distraction_mask, NULL);
     printf("\nFocus Mode complete. All distractions are now unblocked.\n");
-}
\ No newline at end of file
+    if (latency_mode) {
+        fflush(stdout);
+        print_latency_report();
+        free(round_timings);
+        round_timings = NULL;
+    }
+}
+
+// distraction client (./ex3 Distract <pid> <key> [count] [--rate n]): queues count
+// distractions of one type (its menu key) at a focus mode process, at most rate per second
+// (0: as fast as possible). when the receiver's queue is full, waits a little and tries again.
+void runDistractionClient(pid_t pid, char key, long count, long rate) {
+    int t = 0;
+    while (t < NUM_DISTRACTION_TYPES && distraction_types[t].key != key)
+        t++;
+    if (t == NUM_DISTRACTION_TYPES) {
+        printf("Unknown distraction: %c\n", key);
+        return;
+    }
+    int signum = queued_signal(&distraction_types[t]);
+    long retries = 0;
+    long long start = monotonic_us();
+    for (long i = 0; i < count; i++) {
+        if (rate > 0) {
+            long long due = start + i * 1000000LL / rate;
+            long long wait = due - monotonic_us();
+            if (wait > 0) {
+                struct timespec delay = {wait / 1000000, (wait % 1000000) * 1000};
+                nanosleep(&delay, NULL);
+            }
+        }
+        union sigval value;
+        value.sival_ptr = (void *)(intptr_t)monotonic_us();
+        while (sigqueue(pid, signum, value) == -1) {
+            if (errno != EAGAIN) {
+                perror("Failed to send distraction");
+                return;
+            }
+            retries++;
+            sched_yield();
+        }
+    }
+    double elapsed = (monotonic_us() - start) / 1e6;
+    printf("Sent %ld distractions to %d in %.3f s (%.0f/s, %ld retries on a full queue)\n", count, pid, elapsed,
+           elapsed > 0 ? count / elapsed : 0.0, retries);
+}
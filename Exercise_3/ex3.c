@@ -1,3 +1,4 @@
+#define _GNU_SOURCE // sched_setaffinity
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -5,7 +6,13 @@
 #include "CPU-Scheduler.c"
 
 int main(int argc, char *argv[]) {
-    if (argc != 4) {
+    // optional flags after the three arguments (Focus-Mode): --timed, --latency
+    // distraction client: Distract <pid> <distraction key (1/2/3)> [count] [--rate n]
+    // optional flags after the three arguments (CPU-Scheduler):
+    // --simulate, --parallel, --preemptive, --mlfq-quanta q1,q2,..., --mlfq-aging n,
+    // --cores m, --placement global/steal/affinity, --pin, --time-unit s/ms/us, --cpu-bound,
+    // --metrics file.json/file.csv, --metrics-summary, --algorithms fcfs,sjf,priority,rr,srtf,pp,mlfq,multicore
+    if (argc < 4) {
         printf("Usage: %s <Focus-Mode/CPU-Schedule> <Num-Of-Rounds/Processes.csv> <Round-Duration/Time-Quantum>",
                argv[0]);
         exit(0);
@@ -17,13 +24,105 @@ int main(int argc, char *argv[]) {
         exit(0);
     }
 
+    if (strcmp(argv[1], "Distract") == 0) {
+        long count = 1;
+        long rate = 0;
+        for (int i = 4; i < argc; i++) {
+            if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+                rate = atol(argv[++i]);
+            } else if (argv[i][0] != '-') {
+                count = atol(argv[i]);
+            } else {
+                printf("Unknown option: %s\n", argv[i]);
+                exit(0);
+            }
+        }
+        runDistractionClient(atoi(argv[2]), argv[3][0], count, rate);
+    }
+
     if (strcmp(argv[1], "Focus-Mode") == 0) {
         int numOfRounds = atoi(argv[2]);
         int roundDuration = atoi(argv[3]);
+        for (int i = 4; i < argc; i++) {
+            if (strcmp(argv[i], "--timed") == 0) {
+                timed_rounds = 1;
+            } else if (strcmp(argv[i], "--latency") == 0) {
+                latency_mode = 1;
+            } else {
+                printf("Unknown option: %s\n", argv[i]);
+                exit(0);
+            }
+        }
         runFocusMode(numOfRounds, roundDuration);
     }
 
     if (strcmp(argv[1], "CPU-Scheduler") == 0) {
+        for (int i = 4; i < argc; i++) {
+            if (strcmp(argv[i], "--simulate") == 0) {
+                simulate_mode = 1;
+            } else if (strcmp(argv[i], "--parallel") == 0) {
+                parallel_mode = 1;
+            } else if (strcmp(argv[i], "--preemptive") == 0) {
+                preemptive_mode = 1;
+            } else if (strcmp(argv[i], "--mlfq-quanta") == 0 && i + 1 < argc) {
+                if (parse_mlfq_quanta(argv[++i]) == -1) {
+                    printf("Invalid MLFQ quanta: %s\n", argv[i]);
+                    exit(0);
+                }
+            } else if (strcmp(argv[i], "--mlfq-aging") == 0 && i + 1 < argc) {
+                mlfq_aging = atoi(argv[++i]);
+            } else if (strcmp(argv[i], "--cores") == 0 && i + 1 < argc) {
+                num_cores = atoi(argv[++i]);
+                if (num_cores < 1) {
+                    printf("Invalid number of cores: %s\n", argv[i]);
+                    exit(0);
+                }
+            } else if (strcmp(argv[i], "--placement") == 0 && i + 1 < argc) {
+                i++;
+                if (strcmp(argv[i], "global") == 0) {
+                    placement_policy = PLACEMENT_GLOBAL;
+                } else if (strcmp(argv[i], "steal") == 0) {
+                    placement_policy = PLACEMENT_STEAL;
+                } else if (strcmp(argv[i], "affinity") == 0) {
+                    placement_policy = PLACEMENT_AFFINITY;
+                } else {
+                    printf("Unknown placement: %s\n", argv[i]);
+                    exit(0);
+                }
+            } else if (strcmp(argv[i], "--pin") == 0) {
+                pin_children = 1;
+            } else if (strcmp(argv[i], "--cpu-bound") == 0) {
+                cpu_bound_mode = 1;
+            } else if (strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+                metrics_path = argv[++i];
+            } else if (strcmp(argv[i], "--metrics-summary") == 0) {
+                metrics_summary_only = 1;
+            } else if (strcmp(argv[i], "--algorithms") == 0 && i + 1 < argc) {
+                if (parse_algorithm_list(argv[++i]) == -1) {
+                    printf("Invalid algorithm list: %s\n", argv[i]);
+                    exit(0);
+                }
+            } else if (strcmp(argv[i], "--time-unit") == 0 && i + 1 < argc) {
+                i++;
+                if (strcmp(argv[i], "s") == 0) {
+                    time_unit_ns = 1000000000LL;
+                } else if (strcmp(argv[i], "ms") == 0) {
+                    time_unit_ns = 1000000LL;
+                } else if (strcmp(argv[i], "us") == 0) {
+                    time_unit_ns = 1000LL;
+                } else {
+                    printf("Unknown time unit: %s\n", argv[i]);
+                    exit(0);
+                }
+            } else {
+                printf("Unknown option: %s\n", argv[i]);
+                exit(0);
+            }
+        }
+        if ((algorithm_mask & (1u << 7)) && num_cores == 0) {
+            printf("multicore needs --cores\n");
+            exit(0);
+        }
         char *processesCsvFilePath = argv[2];
         int timeQuantum = atoi(argv[3]);
         runCPUScheduler(processesCsvFilePath, timeQuantum);
@@ -0,0 +1,274 @@
+import argparse
+import json
+import os
+import random
+import subprocess
+import sys
+import tempfile
+import time
+
+# policy key (as accepted by --algorithms) -> name in the reports
+POLICIES = {
+    "fcfs": "FCFS",
+    "sjf": "SJF",
+    "priority": "Priority",
+    "rr": "Round Robin",
+    "srtf": "SRTF",
+    "pp": "Preemptive Priority",
+    "mlfq": "MLFQ",
+    "multicore": "Multi-Core Round Robin",
+}
+
+SHAPES = ("poisson", "heavy-tail", "bursty-priority")
+
+# every timeline line of a report ("a → b: ...") is one scheduling event
+EVENT_MARK = "→".encode()
+
+# any change in one of these is reported as a schedule change
+QUALITY_KEYS = ("makespan", "cpu_utilization", "waiting", "turnaround", "response")
+
+# runs shorter than this (in both results) are too noisy to compare throughput
+MIN_COMPARED_SEC = 0.05
+
+# part of the trace file names, bump it when generate_jobs changes so cached traces are regenerated
+TRACE_VERSION = 2
+
+# heavy-tail bursts: int(2 * pareto(1.2)), capped so a trace of 10^7 stays inside an int
+PARETO_ALPHA = 1.2
+PARETO_SCALE = 2
+MAX_BURST = 10000
+
+
+def capped_pareto_mean(alpha, scale, cap):
+    """Mean of min(cap, int(scale * pareto(alpha))): the sum over k >= 1 of P(burst >= k)."""
+    return sum(min(1.0, (scale / k) ** alpha) for k in range(1, cap + 1))
+
+
+def generate_jobs(shape, count, rng):
+    """
+    Yields (arrival, burst, priority) for count processes of the given shape.
+    All shapes keep a single core at about 90-95% load, so queues build up but don't grow forever.
+      poisson:         Poisson arrivals, exponential bursts (mean 8), uniform priorities 1-10.
+      heavy-tail:      Poisson arrivals, capped Pareto bursts (alpha 1.2, mostly short jobs, a few huge ones).
+      bursty-priority: arrivals in bursts of ~50 processes, 20% short high priority (1-3) jobs
+                       and 80% long low priority (7-10) jobs.
+    """
+    clock = 0.0
+    if shape == "poisson":
+        mean_burst = 8.0
+        rate = 0.95 / mean_burst
+        for _ in range(count):
+            clock += rng.expovariate(rate)
+            yield int(clock), max(1, round(rng.expovariate(1.0 / mean_burst))), rng.randint(1, 10)
+    elif shape == "heavy-tail":
+        # pareto(1.2) * 2 has mean 12, but the cap and the rounding bring it down to about 9.7
+        mean_burst = capped_pareto_mean(PARETO_ALPHA, PARETO_SCALE, MAX_BURST)
+        rate = 0.95 / mean_burst
+        for _ in range(count):
+            clock += rng.expovariate(rate)
+            burst = min(MAX_BURST, int(PARETO_SCALE * rng.paretovariate(PARETO_ALPHA)))
+            yield int(clock), burst, rng.randint(1, 10)
+    elif shape == "bursty-priority":
+        # average burst: 0.2 * 2 + 0.8 * 15 = 12.4, a group of ~50 arrives within a few time units
+        mean_group = 50
+        generated = 0
+        while generated < count:
+            group = min(count - generated, 1 + int(rng.expovariate(1.0 / mean_group)))
+            start = int(clock)
+            for _ in range(group):
+                if rng.random() < 0.2:
+                    yield start + rng.randint(0, 3), rng.randint(1, 3), rng.randint(1, 3)
+                else:
+                    yield start + rng.randint(0, 3), rng.randint(5, 25), rng.randint(7, 10)
+            generated += group
+            clock += group * 12.4 / 0.9
+    else:
+        raise ValueError(f"unknown shape {shape}")
+
+
+def write_trace(path, shape, count, seed):
+    """Writes a trace CSV (in the format of CPU-Scheduler-Tests) unless it's already there."""
+    if os.path.exists(path):
+        return
+    rng = random.Random(f"{shape}/{count}/{seed}")
+    partial = path + ".partial"
+    with open(partial, "w") as f_out:
+        f_out.write(f"# {shape} trace, {count} processes, seed {seed}\n")
+        lines = []
+        for i, (arrival, burst, priority) in enumerate(generate_jobs(shape, count, rng)):
+            lines.append(f"P{i + 1},{shape} job,{arrival},{burst},{priority}\n")
+            if len(lines) == 100000:
+                f_out.write("".join(lines))
+                lines = []
+        f_out.write("".join(lines))
+    os.replace(partial, path)
+
+
+def run_policy(binary, trace, policy, quantum, cores, metrics_path):
+    """
+    Runs one policy on one trace in simulation mode.
+    Returns (events, wall seconds, peak RSS in KB, the policy's metrics summary).
+    The peak RSS comes from the scheduler itself: rusage of a child counts the memory of the
+    (python) parent it was forked from.
+    """
+    command = [binary, "CPU-Scheduler", trace, str(quantum), "--simulate", "--algorithms", policy,
+               "--metrics", metrics_path, "--metrics-summary"]
+    if policy == "multicore":
+        command += ["--cores", str(cores)]
+
+    started = time.perf_counter()
+    process = subprocess.Popen(command, stdout=subprocess.PIPE)
+    events = 0
+    tail = b""
+    while True:
+        chunk = process.stdout.read(1 << 20)
+        if not chunk:
+            break
+        # the mark is 3 bytes long and may be cut in two by the chunk boundary,
+        # the last 2 bytes (never a whole mark) are looked at again with the next chunk
+        data = tail + chunk
+        events += data.count(EVENT_MARK)
+        tail = data[-(len(EVENT_MARK) - 1):]
+    _, status = os.waitpid(process.pid, 0)
+    wall = time.perf_counter() - started
+    if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+        raise RuntimeError(f"{' '.join(command)} failed with status {status}")
+
+    with open(metrics_path) as f_in:
+        metrics = json.load(f_in)
+    os.remove(metrics_path)
+    return events, wall, metrics["peak_rss_kb"], metrics["algorithms"][0]
+
+
+def parse_size(text):
+    """Accepts 1000, 1e6, 10^7 ..."""
+    if "^" in text:
+        base, exponent = text.split("^")
+        return int(base) ** int(exponent)
+    return int(float(text))
+
+
+def compare_with_baseline(results, settings, baseline_path, tolerance):
+    """
+    Reports throughput drops and memory growth beyond tolerance, and any change in schedule quality
+    (the schedules are deterministic, so the same trace must give the same numbers).
+    Returns the number of problems found.
+    """
+    with open(baseline_path) as f_in:
+        baseline_run = json.load(f_in)
+    baseline = {(r["shape"], r["size"], r["policy"]): r for r in baseline_run["results"]}
+    for setting, value in settings.items():
+        if baseline_run.get(setting) != value:
+            print(f"  note: the baseline ran with {setting} {baseline_run.get(setting)}, this run with {value}")
+
+    problems = 0
+    for result in results:
+        key = (result["shape"], result["size"], result["policy"])
+        old = baseline.get(key)
+        if old is None:
+            continue
+        label = f"{key[0]}/{key[1]}/{key[2]}"
+        long_enough = min(result["engine_sec"], old["engine_sec"]) >= MIN_COMPARED_SEC
+        if long_enough and result["events_per_sec"] < old["events_per_sec"] * (1 - tolerance):
+            print(f"  REGRESSION {label}: {old['events_per_sec']:.0f} -> {result['events_per_sec']:.0f} events/s")
+            problems += 1
+        if result["max_rss_kb"] > old["max_rss_kb"] * (1 + tolerance):
+            print(f"  REGRESSION {label}: max RSS {old['max_rss_kb']} -> {result['max_rss_kb']} KB")
+            problems += 1
+        for quality_key in QUALITY_KEYS:
+            if result["quality"][quality_key] != old["quality"][quality_key]:
+                print(f"  SCHEDULE CHANGED {label}: {quality_key} {old['quality'][quality_key]} -> "
+                      f"{result['quality'][quality_key]}")
+                problems += 1
+    return problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Benchmarks the CPU-Scheduler policies on synthetic traces "
+                                                 "in simulation mode.")
+    parser.add_argument("--binary", help="ex3 executable (default: compile ex3.c with gcc -O2)")
+    parser.add_argument("--sizes", default="1e3,1e4,1e5,1e6",
+                        help="comma separated trace sizes, up to 1e7 (default: %(default)s)")
+    parser.add_argument("--shapes", default=",".join(SHAPES), help="comma separated trace shapes "
+                                                                    "(default: %(default)s)")
+    parser.add_argument("--policies", default=",".join(POLICIES), help="comma separated policies "
+                                                                        "(default: %(default)s)")
+    parser.add_argument("--quantum", type=int, default=4, help="time quantum (default: %(default)s)")
+    parser.add_argument("--cores", type=int, default=4, help="cores for multicore (default: %(default)s)")
+    parser.add_argument("--repeat", type=int, default=1, help="runs per policy, the fastest counts "
+                                                              "(default: %(default)s)")
+    parser.add_argument("--seed", type=int, default=1, help="trace seed (default: %(default)s)")
+    parser.add_argument("--workdir", default=os.path.join(tempfile.gettempdir(), "cpu-scheduler-benchmark"),
+                        help="where traces are generated and kept between runs (default: %(default)s)")
+    parser.add_argument("--json", help="write the results to this file")
+    parser.add_argument("--baseline", help="results of an earlier --json run to compare against")
+    parser.add_argument("--tolerance", type=float, default=0.2,
+                        help="allowed throughput drop / memory growth against the baseline (default: %(default)s)")
+    args = parser.parse_args()
+
+    sizes = [parse_size(s) for s in args.sizes.split(",")]
+    shapes = args.shapes.split(",")
+    policies = args.policies.split(",")
+    for shape in shapes:
+        if shape not in SHAPES:
+            parser.error(f"unknown shape {shape}")
+    for policy in policies:
+        if policy not in POLICIES:
+            parser.error(f"unknown policy {policy}")
+
+    os.makedirs(args.workdir, exist_ok=True)
+    binary = args.binary
+    if binary is None:
+        binary = os.path.join(args.workdir, "ex3")
+        source = os.path.join(os.path.dirname(os.path.abspath(__file__)), "ex3.c")
+        subprocess.run(["gcc", "-O2", "-o", binary, source], check=True)
+    binary = os.path.abspath(binary)
+    metrics_path = os.path.join(args.workdir, f"metrics_{os.getpid()}.json")
+
+    print(f"{'shape':<16}{'size':>9}  {'policy':<10}{'events':>11}{'wall s':>9}{'engine s':>10}"
+          f"{'events/s':>12}{'RSS MB':>8}{'avg wait':>10}{'p95 wait':>10}{'p99 turn':>10}{'p99 resp':>10}"
+          f"{'util':>7}")
+    results = []
+    for shape in shapes:
+        for size in sizes:
+            trace = os.path.join(args.workdir, f"{shape}_{size}_{args.seed}_v{TRACE_VERSION}.csv")
+            write_trace(trace, shape, size, args.seed)
+            for policy in policies:
+                best = None
+                for _ in range(args.repeat):
+                    run = run_policy(binary, trace, policy, args.quantum, args.cores, metrics_path)
+                    if best is None or run[3]["elapsed_ms"] < best[3]["elapsed_ms"]:
+                        best = run
+                events, wall, max_rss_kb, summary = best
+                engine = summary["elapsed_ms"] / 1000
+                events_per_sec = events / engine if engine > 0 else 0.0
+                print(f"{shape:<16}{size:>9}  {policy:<10}{events:>11}{wall:>9.2f}{engine:>10.3f}"
+                      f"{events_per_sec:>12.0f}{max_rss_kb / 1024:>8.1f}{summary['waiting']['avg']:>10.1f}"
+                      f"{summary['waiting']['p95']:>10}{summary['turnaround']['p99']:>10}"
+                      f"{summary['response']['p99']:>10}{summary['cpu_utilization']:>7.3f}", flush=True)
+                results.append({
+                    "shape": shape,
+                    "size": size,
+                    "policy": policy,
+                    "events": events,
+                    "wall_sec": wall,
+                    "engine_sec": engine,
+                    "events_per_sec": events_per_sec,
+                    "max_rss_kb": max_rss_kb,
+                    "quality": {key: summary[key] for key in QUALITY_KEYS},
+                })
+
+    settings = {"quantum": args.quantum, "cores": args.cores, "seed": args.seed}
+    if args.json:
+        with open(args.json, "w") as f_out:
+            json.dump(dict(settings, results=results), f_out, indent=2)
+
+    if args.baseline:
+        print(f"\nComparing with {args.baseline} (tolerance {args.tolerance:.0%})")
+        problems = compare_with_baseline(results, settings, args.baseline, args.tolerance)
+        print("  no regressions" if problems == 0 else f"  {problems} problem(s)")
+        sys.exit(1 if problems else 0)
+
+
+if __name__ == "__main__":
+    main()